@@ -29,6 +29,12 @@ static DWORD ror(DWORD n, int k) { return (n >> k) | (n << (32-k)); }
 #define S1(x)      (ror(x,6) ^ ror(x,11) ^ ror(x,25))
 #define R0(x)      (ror(x,7) ^ ror(x,18) ^ (x>>3))
 #define R1(x)      (ror(x,17) ^ ror(x,19) ^ (x>>10))
+#define ROUND(a,b,c,d,e,f,g,h,i) \
+    do { \
+        t1 = h + S1(e) + Ch(e,f,g) + K[i] + W[i]; \
+        d += t1; \
+        h = t1 + S0(a) + Maj(a,b,c); \
+    } while (0)
 
 static const DWORD K[64] =
 {
@@ -44,7 +50,7 @@ static const DWORD K[64] =
 
 static void processblock(SHA256_CTX *ctx, const UCHAR *buffer)
 {
-    DWORD W[64], t1, t2, a, b, c, d, e, f, g, h;
+    DWORD W[64], t1, a, b, c, d, e, f, g, h;
     int i;
 
     for (i = 0; i < 16; i++)
@@ -67,18 +73,17 @@ static void processblock(SHA256_CTX *ctx, const UCHAR *buffer)
     g = ctx->h[6];
     h = ctx->h[7];
 
-    for (i = 0; i < 64; i++)
+    /* unroll by 8 and rotate the variable names instead of their values */
+    for (i = 0; i < 64; i += 8)
     {
-        t1 = h + S1(e) + Ch(e,f,g) + K[i] + W[i];
-        t2 = S0(a) + Maj(a,b,c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
+        ROUND(a,b,c,d,e,f,g,h,i);
+        ROUND(h,a,b,c,d,e,f,g,i+1);
+        ROUND(g,h,a,b,c,d,e,f,i+2);
+        ROUND(f,g,h,a,b,c,d,e,i+3);
+        ROUND(e,f,g,h,a,b,c,d,i+4);
+        ROUND(d,e,f,g,h,a,b,c,i+5);
+        ROUND(c,d,e,f,g,h,a,b,i+6);
+        ROUND(b,c,d,e,f,g,h,a,i+7);
     }
 
     ctx->h[0] += a;
@@ -1124,10 +1124,17 @@ static cab_LONG fdi_Zipinflate_codes(const struct Ziphuft *tl, const struct Ziph
         e = ZIPWSIZE - max(d, w);
         e = min(e, n);
         n -= e;
-        do
+        if (d >= w || w - d >= e) /* source not behind the output run */
         {
-          CAB(outbuf)[w++] = CAB(outbuf)[d++];
-        } while (--e);
+          memmove(CAB(outbuf) + w, CAB(outbuf) + d, e);
+          w += e;
+          d += e;
+        }
+        else                    /* overlapping run, copy bytewise */
+          do
+          {
+            CAB(outbuf)[w++] = CAB(outbuf)[d++];
+          } while (--e);
       } while (n);
     }
   }
@@ -1170,14 +1177,19 @@ static cab_LONG fdi_Zipinflate_stored(fdi_decomp_state *decomp_state)
     return 1;                   /* error in compressed data */
   ZIPDUMPBITS(16)
 
-  /* read and output the compressed data */
-  while(n--)
+  /* flush any whole bytes left in the bit buffer */
+  while(n && k)
   {
-    ZIPNEEDBITS(8)
     CAB(outbuf)[w++] = (cab_UBYTE)b;
     ZIPDUMPBITS(8)
+    n--;
   }
 
+  /* the bit buffer is empty now, so copy the rest straight from the input */
+  memcpy(CAB(outbuf) + w, ZIP(inpos), n);
+  ZIP(inpos) += n;
+  w += n;
+
   /* restore the globals from the locals */
   ZIP(window_posn) = w;              /* restore global window pointer */
   ZIP(bb) = b;                       /* restore global bit buffer */
@@ -277,6 +277,7 @@ struct d3dx_regstore
 };
 
 struct d3dx_pres_ins;
+struct d3dx_pres_prog_ins;
 
 struct d3dx_preshader
 {
@@ -285,6 +286,9 @@ struct d3dx_preshader
     unsigned int ins_count;
     struct d3dx_pres_ins *ins;
 
+    unsigned int prog_count;
+    struct d3dx_pres_prog_ins *prog;
+
     struct d3dx_const_tab inputs;
 };
 
@@ -54,8 +54,6 @@ enum pres_ops
     PRESHADER_OP_DOTSWIZ8,
 };
 
-typedef double (*pres_op_func)(double *args, int n);
-
 static double to_signed_nan(double v)
 {
     static const union
@@ -152,36 +150,35 @@ struct op_info
     char mnem[16];
     unsigned int input_count;
     BOOL func_all_comps;
-    pres_op_func func;
 };
 
 static const struct op_info pres_op_info[] =
 {
-    {0x000, "nop", 0, 0, NULL    }, /* PRESHADER_OP_NOP */
-    {0x100, "mov", 1, 0, pres_mov}, /* PRESHADER_OP_MOV */
-    {0x101, "neg", 1, 0, pres_neg}, /* PRESHADER_OP_NEG */
-    {0x103, "rcp", 1, 0, pres_rcp}, /* PRESHADER_OP_RCP */
-    {0x104, "frc", 1, 0, pres_frc}, /* PRESHADER_OP_FRC */
-    {0x105, "exp", 1, 0, pres_exp}, /* PRESHADER_OP_EXP */
-    {0x106, "log", 1, 0, pres_log}, /* PRESHADER_OP_LOG */
-    {0x107, "rsq", 1, 0, pres_rsq}, /* PRESHADER_OP_RSQ */
-    {0x108, "sin", 1, 0, pres_sin}, /* PRESHADER_OP_SIN */
-    {0x109, "cos", 1, 0, pres_cos}, /* PRESHADER_OP_COS */
-    {0x10a, "asin", 1, 0, pres_asin}, /* PRESHADER_OP_ASIN */
-    {0x10b, "acos", 1, 0, pres_acos}, /* PRESHADER_OP_ACOS */
-    {0x10c, "atan", 1, 0, pres_atan}, /* PRESHADER_OP_ATAN */
-    {0x200, "min", 2, 0, pres_min}, /* PRESHADER_OP_MIN */
-    {0x201, "max", 2, 0, pres_max}, /* PRESHADER_OP_MAX */
-    {0x202, "lt",  2, 0, pres_lt }, /* PRESHADER_OP_LT  */
-    {0x203, "ge",  2, 0, pres_ge }, /* PRESHADER_OP_GE  */
-    {0x204, "add", 2, 0, pres_add}, /* PRESHADER_OP_ADD */
-    {0x205, "mul", 2, 0, pres_mul}, /* PRESHADER_OP_MUL */
-    {0x206, "atan2", 2, 0, pres_atan2}, /* PRESHADER_OP_ATAN2 */
-    {0x208, "div", 2, 0, pres_div}, /* PRESHADER_OP_DIV */
-    {0x300, "cmp", 3, 0, pres_cmp}, /* PRESHADER_OP_CMP */
-    {0x500, "dot", 2, 1, pres_dot}, /* PRESHADER_OP_DOT */
-    {0x70e, "d3ds_dotswiz", 6, 0, pres_dotswiz6}, /* PRESHADER_OP_DOTSWIZ6 */
-    {0x70e, "d3ds_dotswiz", 8, 0, pres_dotswiz8}, /* PRESHADER_OP_DOTSWIZ8 */
+    {0x000, "nop", 0, 0}, /* PRESHADER_OP_NOP */
+    {0x100, "mov", 1, 0}, /* PRESHADER_OP_MOV */
+    {0x101, "neg", 1, 0}, /* PRESHADER_OP_NEG */
+    {0x103, "rcp", 1, 0}, /* PRESHADER_OP_RCP */
+    {0x104, "frc", 1, 0}, /* PRESHADER_OP_FRC */
+    {0x105, "exp", 1, 0}, /* PRESHADER_OP_EXP */
+    {0x106, "log", 1, 0}, /* PRESHADER_OP_LOG */
+    {0x107, "rsq", 1, 0}, /* PRESHADER_OP_RSQ */
+    {0x108, "sin", 1, 0}, /* PRESHADER_OP_SIN */
+    {0x109, "cos", 1, 0}, /* PRESHADER_OP_COS */
+    {0x10a, "asin", 1, 0}, /* PRESHADER_OP_ASIN */
+    {0x10b, "acos", 1, 0}, /* PRESHADER_OP_ACOS */
+    {0x10c, "atan", 1, 0}, /* PRESHADER_OP_ATAN */
+    {0x200, "min", 2, 0}, /* PRESHADER_OP_MIN */
+    {0x201, "max", 2, 0}, /* PRESHADER_OP_MAX */
+    {0x202, "lt",  2, 0}, /* PRESHADER_OP_LT  */
+    {0x203, "ge",  2, 0}, /* PRESHADER_OP_GE  */
+    {0x204, "add", 2, 0}, /* PRESHADER_OP_ADD */
+    {0x205, "mul", 2, 0}, /* PRESHADER_OP_MUL */
+    {0x206, "atan2", 2, 0}, /* PRESHADER_OP_ATAN2 */
+    {0x208, "div", 2, 0}, /* PRESHADER_OP_DIV */
+    {0x300, "cmp", 3, 0}, /* PRESHADER_OP_CMP */
+    {0x500, "dot", 2, 1}, /* PRESHADER_OP_DOT */
+    {0x70e, "d3ds_dotswiz", 6, 0}, /* PRESHADER_OP_DOTSWIZ6 */
+    {0x70e, "d3ds_dotswiz", 8, 0}, /* PRESHADER_OP_DOTSWIZ8 */
 };
 
 enum pres_value_type
@@ -257,6 +254,29 @@ struct d3dx_pres_ins
     struct d3dx_pres_operand output;
 };
 
+struct d3dx_pres_prog_arg
+{
+    /* first component, or NULL when read through exec_get_arg() */
+    const void *ptr;
+    enum pres_value_type type;
+    /* 0 for the scalar argument propagated to all components */
+    unsigned int step;
+    const struct d3dx_pres_operand *opr;
+};
+
+/* instruction with resolved register pointers, run by execute_preshader() */
+struct d3dx_pres_prog_ins
+{
+    enum pres_ops op;
+    unsigned int component_count;
+    unsigned int input_count;
+    /* an input reads an output component written earlier by the instruction */
+    BOOL ordered;
+    struct d3dx_pres_prog_arg inputs[MAX_INPUTS_COUNT];
+    void *output;
+    enum pres_value_type output_type;
+};
+
 struct const_upload_info
 {
     BOOL transpose;
@@ -354,23 +374,6 @@ static double regstore_get_double(struct d3dx_regstore *rs, unsigned int table,
     }
 }
 
-static void regstore_set_double(struct d3dx_regstore *rs, unsigned int table, unsigned int offset, double v)
-{
-    BYTE *p;
-
-    p = (BYTE *)rs->tables[table] + table_info[table].component_size * offset;
-    switch (table_info[table].type)
-    {
-        case PRES_VT_FLOAT : *(float *)p = v; break;
-        case PRES_VT_DOUBLE: *(double *)p = v; break;
-        case PRES_VT_INT   : *(int *)p = lrint(v); break;
-        case PRES_VT_BOOL  : *(BOOL *)p = !!v; break;
-        default:
-            FIXME("Bad type %u.\n", table_info[table].type);
-            break;
-    }
-}
-
 static void dump_bytecode(void *data, unsigned int size)
 {
     unsigned int *bytecode = (unsigned int *)data;
@@ -1220,6 +1223,8 @@ static HRESULT parse_preshader(struct d3dx_preshader *pres, unsigned int *ptr, u
     return D3D_OK;
 }
 
+static HRESULT compile_preshader(struct d3dx_preshader *pres);
+
 HRESULT d3dx_create_param_eval(struct d3dx_effect *effect, void *byte_code, unsigned int byte_code_size,
         D3DXPARAMETER_TYPE type, struct d3dx_param_eval **peval_out, ULONG64 *version_counter,
         const char **skip_constants, unsigned int skip_constants_count)
@@ -1306,6 +1311,9 @@ HRESULT d3dx_create_param_eval(struct d3dx_effect *effect, void *byte_code, unsi
             goto err_out;
     }
 
+    if (FAILED(ret = compile_preshader(&peval->pres)))
+        goto err_out;
+
     if (TRACE_ON(d3dx))
     {
         dump_bytecode(byte_code, byte_code_size);
@@ -1340,6 +1348,7 @@ static void d3dx_free_const_tab(struct d3dx_const_tab *ctab)
 static void d3dx_free_preshader(struct d3dx_preshader *pres)
 {
     HeapFree(GetProcessHeap(), 0, pres->ins);
+    HeapFree(GetProcessHeap(), 0, pres->prog);
 
     regstore_free_tables(&pres->regs);
     d3dx_free_const_tab(&pres->inputs);
@@ -1603,10 +1612,11 @@ static double exec_get_arg(struct d3dx_regstore *rs, const struct d3dx_pres_oper
 
     table = opr->reg.table;
 
+    /* Registers of non relative operands are range checked in parse_preshader(). */
     if (opr->index_reg.table == PRES_REGTAB_COUNT)
-        base_index = 0;
-    else
-        base_index = lrint(exec_get_reg_value(rs, opr->index_reg.table, opr->index_reg.offset));
+        return exec_get_reg_value(rs, table, opr->reg.offset + comp);
+
+    base_index = lrint(exec_get_reg_value(rs, opr->index_reg.table, opr->index_reg.offset));
 
     offset = get_offset_reg(table, base_index) + opr->reg.offset + comp;
     reg_index = get_reg_offset(table, offset);
@@ -1639,53 +1649,360 @@ static double exec_get_arg(struct d3dx_regstore *rs, const struct d3dx_pres_oper
     return exec_get_reg_value(rs, table, offset);
 }
 
-static void exec_set_arg(struct d3dx_regstore *rs, const struct d3dx_pres_reg *reg,
-        unsigned int comp, double res)
+/* Reads components first to first + count - 1 of an input into args[][input]. */
+static void exec_load(struct d3dx_regstore *rs, const struct d3dx_pres_prog_arg *arg, unsigned int input,
+        double (*args)[MAX_INPUTS_COUNT], unsigned int first, unsigned int count)
 {
-    regstore_set_double(rs, reg->table, reg->offset + comp, res);
+    unsigned int j;
+
+    switch (arg->type)
+    {
+        case PRES_VT_FLOAT:
+            for (j = first; j < first + count; ++j)
+                args[j][input] = ((const float *)arg->ptr)[j * arg->step];
+            break;
+        case PRES_VT_DOUBLE:
+            for (j = first; j < first + count; ++j)
+                args[j][input] = ((const double *)arg->ptr)[j * arg->step];
+            break;
+        default:
+            for (j = first; j < first + count; ++j)
+                args[j][input] = exec_get_arg(rs, arg->opr, j * arg->step);
+            break;
+    }
 }
 
-#define ARGS_ARRAY_SIZE 8
-static HRESULT execute_preshader(struct d3dx_preshader *pres)
+static void exec_store(const struct d3dx_pres_prog_ins *pins, const double *res,
+        unsigned int first, unsigned int count)
+{
+    unsigned int j;
+
+    switch (pins->output_type)
+    {
+        case PRES_VT_FLOAT:
+            for (j = first; j < first + count; ++j)
+                ((float *)pins->output)[j] = res[j];
+            break;
+        case PRES_VT_DOUBLE:
+            for (j = first; j < first + count; ++j)
+                ((double *)pins->output)[j] = res[j];
+            break;
+        case PRES_VT_INT:
+            for (j = first; j < first + count; ++j)
+                ((int *)pins->output)[j] = lrint(res[j]);
+            break;
+        case PRES_VT_BOOL:
+            for (j = first; j < first + count; ++j)
+                ((BOOL *)pins->output)[j] = !!res[j];
+            break;
+        default:
+            FIXME("Bad type %u.\n", pins->output_type);
+            break;
+    }
+}
+
+/* Computes components first to first + count - 1 of an instruction. */
+static void exec_op(enum pres_ops op, double (*args)[MAX_INPUTS_COUNT], unsigned int n,
+        double *res, unsigned int first, unsigned int count)
+{
+    unsigned int j;
+
+#define PRES_OP_CASE(op, func) \
+        case op: \
+            for (j = first; j < first + count; ++j) \
+                res[j] = func(args[j], n); \
+            break;
+
+    switch (op)
+    {
+        PRES_OP_CASE(PRESHADER_OP_MOV, pres_mov)
+        PRES_OP_CASE(PRESHADER_OP_NEG, pres_neg)
+        PRES_OP_CASE(PRESHADER_OP_RCP, pres_rcp)
+        PRES_OP_CASE(PRESHADER_OP_FRC, pres_frc)
+        PRES_OP_CASE(PRESHADER_OP_EXP, pres_exp)
+        PRES_OP_CASE(PRESHADER_OP_LOG, pres_log)
+        PRES_OP_CASE(PRESHADER_OP_RSQ, pres_rsq)
+        PRES_OP_CASE(PRESHADER_OP_SIN, pres_sin)
+        PRES_OP_CASE(PRESHADER_OP_COS, pres_cos)
+        PRES_OP_CASE(PRESHADER_OP_ASIN, pres_asin)
+        PRES_OP_CASE(PRESHADER_OP_ACOS, pres_acos)
+        PRES_OP_CASE(PRESHADER_OP_ATAN, pres_atan)
+        PRES_OP_CASE(PRESHADER_OP_MIN, pres_min)
+        PRES_OP_CASE(PRESHADER_OP_MAX, pres_max)
+        PRES_OP_CASE(PRESHADER_OP_LT, pres_lt)
+        PRES_OP_CASE(PRESHADER_OP_GE, pres_ge)
+        PRES_OP_CASE(PRESHADER_OP_ADD, pres_add)
+        PRES_OP_CASE(PRESHADER_OP_MUL, pres_mul)
+        PRES_OP_CASE(PRESHADER_OP_ATAN2, pres_atan2)
+        PRES_OP_CASE(PRESHADER_OP_DIV, pres_div)
+        PRES_OP_CASE(PRESHADER_OP_CMP, pres_cmp)
+        PRES_OP_CASE(PRESHADER_OP_DOTSWIZ6, pres_dotswiz6)
+        PRES_OP_CASE(PRESHADER_OP_DOTSWIZ8, pres_dotswiz8)
+        default:
+            FIXME("Unexpected op %u.\n", op);
+            break;
+    }
+
+#undef PRES_OP_CASE
+}
+
+static void exec_prog_ins(struct d3dx_regstore *rs, const struct d3dx_pres_prog_ins *pins)
+{
+    double args[4][MAX_INPUTS_COUNT], res[4];
+    unsigned int j, k;
+
+    if (pins->op == PRESHADER_OP_DOT)
+    {
+        double dot_args[2 * 4];
+
+        for (k = 0; k < 2; ++k)
+        {
+            exec_load(rs, &pins->inputs[k], 0, args, 0, pins->component_count);
+            for (j = 0; j < pins->component_count; ++j)
+                dot_args[k * pins->component_count + j] = args[j][0];
+        }
+        res[0] = pres_dot(dot_args, pins->component_count);
+        exec_store(pins, res, 0, 1);
+        return;
+    }
+
+    /* Inputs are copied before any output component is written, unless an
+     * input reads an output component written earlier by the same instruction. */
+    if (!pins->ordered)
+    {
+        for (k = 0; k < pins->input_count; ++k)
+            exec_load(rs, &pins->inputs[k], k, args, 0, pins->component_count);
+        exec_op(pins->op, args, pins->component_count, res, 0, pins->component_count);
+        exec_store(pins, res, 0, pins->component_count);
+        return;
+    }
+
+    for (j = 0; j < pins->component_count; ++j)
+    {
+        for (k = 0; k < pins->input_count; ++k)
+            exec_load(rs, &pins->inputs[k], k, args, j, 1);
+        exec_op(pins->op, args, pins->component_count, res, j, 1);
+        exec_store(pins, res, j, 1);
+    }
+}
+
+static unsigned int get_ins_output_count(const struct d3dx_pres_ins *ins)
+{
+    return pres_op_info[ins->op].func_all_comps ? 1 : ins->component_count;
+}
+
+static unsigned int get_ins_input_count(const struct d3dx_pres_ins *ins, unsigned int input)
+{
+    return ins->scalar_op && !input ? 1 : ins->component_count;
+}
+
+static BOOL is_temp_range_set(const BOOL *flags, unsigned int offset, unsigned int count)
 {
-    unsigned int i, j, k;
-    double args[ARGS_ARRAY_SIZE];
-    double res;
+    unsigned int i;
+
+    for (i = 0; i < count; ++i)
+        if (!flags[offset + i])
+            return FALSE;
+    return TRUE;
+}
+
+static void init_prog_ins(struct d3dx_regstore *rs, const struct d3dx_pres_ins *ins,
+        struct d3dx_pres_prog_ins *pins)
+{
+    const struct d3dx_pres_reg *out = &ins->output.reg;
+    unsigned int i, j;
+
+    pins->op = ins->op;
+    pins->component_count = ins->component_count;
+    pins->input_count = pres_op_info[ins->op].input_count;
+    pins->ordered = FALSE;
+    pins->output = (BYTE *)rs->tables[out->table] + table_info[out->table].component_size * out->offset;
+    pins->output_type = table_info[out->table].type;
+
+    for (i = 0; i < pins->input_count; ++i)
+    {
+        const struct d3dx_pres_operand *opr = &ins->inputs[i];
+        struct d3dx_pres_prog_arg *arg = &pins->inputs[i];
+
+        arg->opr = opr;
+        arg->step = ins->scalar_op && !i ? 0 : 1;
+        if (opr->index_reg.table != PRES_REGTAB_COUNT)
+        {
+            arg->type = PRES_VT_COUNT;
+            arg->ptr = NULL;
+            if (opr->reg.table == out->table || opr->index_reg.table == out->table)
+                pins->ordered = TRUE;
+            continue;
+        }
+        /* Integer and boolean inputs go through exec_get_arg(), which complains about them. */
+        arg->type = table_info[opr->reg.table].type;
+        arg->ptr = (BYTE *)rs->tables[opr->reg.table]
+                + table_info[opr->reg.table].component_size * opr->reg.offset;
+
+        if (opr->reg.table != out->table || pres_op_info[ins->op].func_all_comps)
+            continue;
+        for (j = 1; j < ins->component_count; ++j)
+        {
+            unsigned int offset = opr->reg.offset + j * arg->step;
+
+            if (offset >= out->offset && offset < out->offset + j)
+                pins->ordered = TRUE;
+        }
+    }
+}
+
+/* Translates the parsed instructions into the program run by execute_preshader().
+ * Instructions only computing temporary registers from immediate constants are
+ * executed here once, and instructions whose temporary outputs are never read
+ * are dropped. */
+static HRESULT compile_preshader(struct d3dx_preshader *pres)
+{
+    struct d3dx_regstore *rs = &pres->regs;
+    unsigned int temp_count, i, j, k, folded_count, dead_count;
+    BOOL *temp_const, *temp_read, *skip, temp_relative, changed;
+    unsigned int *temp_writes, *temp_readers;
+    struct d3dx_pres_prog_ins pins;
+    HRESULT hr = D3D_OK;
+
+    if (!pres->ins_count)
+        return D3D_OK;
+
+    temp_count = get_offset_reg(PRES_REGTAB_TEMP, rs->table_sizes[PRES_REGTAB_TEMP]);
+    temp_const = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*temp_const) * temp_count);
+    temp_read = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*temp_read) * temp_count);
+    temp_writes = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*temp_writes) * temp_count);
+    temp_readers = HeapAlloc(GetProcessHeap(), 0, sizeof(*temp_readers) * temp_count);
+    skip = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(*skip) * pres->ins_count);
+    pres->prog = HeapAlloc(GetProcessHeap(), 0, sizeof(*pres->prog) * pres->ins_count);
+    if ((temp_count && (!temp_const || !temp_read || !temp_writes || !temp_readers)) || !skip || !pres->prog)
+    {
+        hr = E_OUTOFMEMORY;
+        goto done;
+    }
 
+    temp_relative = FALSE;
     for (i = 0; i < pres->ins_count; ++i)
     {
-        const struct d3dx_pres_ins *ins;
-        const struct op_info *oi;
+        const struct d3dx_pres_ins *ins = &pres->ins[i];
+
+        if (ins->op == PRESHADER_OP_NOP)
+            skip[i] = TRUE;
+        for (j = 0; j < pres_op_info[ins->op].input_count; ++j)
+            if (ins->inputs[j].index_reg.table != PRES_REGTAB_COUNT
+                    && (ins->inputs[j].reg.table == PRES_REGTAB_TEMP
+                    || ins->inputs[j].index_reg.table == PRES_REGTAB_TEMP))
+                temp_relative = TRUE;
+        if (ins->output.reg.table == PRES_REGTAB_TEMP)
+            for (j = 0; j < get_ins_output_count(ins); ++j)
+                ++temp_writes[ins->output.reg.offset + j];
+    }
+
+    /* Constant folding. A temporary register written only by an instruction with
+     * constant inputs, and not read before that, keeps its value across runs. */
+    folded_count = 0;
+    for (i = 0; i < pres->ins_count && !temp_relative; ++i)
+    {
+        const struct d3dx_pres_ins *ins = &pres->ins[i];
+        unsigned int out_offset = ins->output.reg.offset;
+        BOOL fold;
 
-        ins = &pres->ins[i];
-        oi = &pres_op_info[ins->op];
-        if (oi->func_all_comps)
+        if (skip[i])
+            continue;
+
+        fold = ins->output.reg.table == PRES_REGTAB_TEMP;
+        for (j = 0; fold && j < get_ins_output_count(ins); ++j)
+            fold = temp_writes[out_offset + j] == 1 && !temp_read[out_offset + j];
+        for (j = 0; j < pres_op_info[ins->op].input_count; ++j)
         {
-            if (oi->input_count * ins->component_count > ARGS_ARRAY_SIZE)
+            const struct d3dx_pres_reg *reg = &ins->inputs[j].reg;
+
+            if (ins->inputs[j].index_reg.table != PRES_REGTAB_COUNT)
+                fold = FALSE;
+            else if (reg->table == PRES_REGTAB_TEMP)
             {
-                FIXME("Too many arguments (%u) for one instruction.\n", oi->input_count * ins->component_count);
-                return E_FAIL;
+                fold = fold && is_temp_range_set(temp_const, reg->offset, get_ins_input_count(ins, j));
+                for (k = 0; k < get_ins_input_count(ins, j); ++k)
+                    temp_read[reg->offset + k] = TRUE;
             }
-            for (k = 0; k < oi->input_count; ++k)
-                for (j = 0; j < ins->component_count; ++j)
-                    args[k * ins->component_count + j] = exec_get_arg(&pres->regs, &ins->inputs[k],
-                            ins->scalar_op && !k ? 0 : j);
-            res = oi->func(args, ins->component_count);
-
-            /* only 'dot' instruction currently falls here */
-            exec_set_arg(&pres->regs, &ins->output.reg, 0, res);
+            else if (reg->table != PRES_REGTAB_IMMED)
+                fold = FALSE;
         }
-        else
+        if (!fold)
+            continue;
+
+        init_prog_ins(rs, ins, &pins);
+        exec_prog_ins(rs, &pins);
+        for (j = 0; j < get_ins_output_count(ins); ++j)
+            temp_const[out_offset + j] = TRUE;
+        skip[i] = TRUE;
+        ++folded_count;
+    }
+
+    /* Dead output elimination. */
+    dead_count = 0;
+    do
+    {
+        changed = FALSE;
+        if (temp_relative)
+            break;
+
+        memset(temp_readers, 0, sizeof(*temp_readers) * temp_count);
+        for (i = 0; i < pres->ins_count; ++i)
         {
-            for (j = 0; j < ins->component_count; ++j)
+            if (skip[i])
+                continue;
+            for (j = 0; j < pres_op_info[pres->ins[i].op].input_count; ++j)
             {
-                for (k = 0; k < oi->input_count; ++k)
-                    args[k] = exec_get_arg(&pres->regs, &ins->inputs[k], ins->scalar_op && !k ? 0 : j);
-                res = oi->func(args, ins->component_count);
-                exec_set_arg(&pres->regs, &ins->output.reg, j, res);
+                const struct d3dx_pres_reg *reg = &pres->ins[i].inputs[j].reg;
+
+                if (reg->table == PRES_REGTAB_TEMP)
+                    for (k = 0; k < get_ins_input_count(&pres->ins[i], j); ++k)
+                        ++temp_readers[reg->offset + k];
             }
         }
+        for (i = 0; i < pres->ins_count; ++i)
+        {
+            const struct d3dx_pres_ins *ins = &pres->ins[i];
+            BOOL dead;
+
+            if (skip[i] || ins->output.reg.table != PRES_REGTAB_TEMP)
+                continue;
+            dead = TRUE;
+            for (j = 0; dead && j < get_ins_output_count(ins); ++j)
+                dead = !temp_readers[ins->output.reg.offset + j];
+            if (dead)
+            {
+                skip[i] = TRUE;
+                ++dead_count;
+                changed = TRUE;
+            }
+        }
+    }
+    while (changed);
+
+    pres->prog_count = 0;
+    for (i = 0; i < pres->ins_count; ++i)
+    {
+        if (!skip[i])
+            init_prog_ins(rs, &pres->ins[i], &pres->prog[pres->prog_count++]);
     }
+    TRACE("%u instructions compiled, %u folded, %u dead.\n", pres->prog_count, folded_count, dead_count);
+
+done:
+    HeapFree(GetProcessHeap(), 0, temp_const);
+    HeapFree(GetProcessHeap(), 0, temp_read);
+    HeapFree(GetProcessHeap(), 0, temp_writes);
+    HeapFree(GetProcessHeap(), 0, temp_readers);
+    HeapFree(GetProcessHeap(), 0, skip);
+    return hr;
+}
+
+static HRESULT execute_preshader(struct d3dx_preshader *pres)
+{
+    unsigned int i;
+
+    for (i = 0; i < pres->prog_count; ++i)
+        exec_prog_ins(&pres->regs, &pres->prog[i]);
     return D3D_OK;
 }
 
@@ -1598,6 +1598,26 @@ static void format_from_vec4(const struct pixel_format_desc *format, const struc
     }
 }
 
+/* Converting between identical formats whose channels cover every bit
+ * of the pixel doesn't change the data, so it can be a plain copy. */
+static BOOL is_identity_conversion(const struct pixel_format_desc *src_format,
+        const struct pixel_format_desc *dst_format, D3DCOLOR color_key)
+{
+    unsigned int c, bits = 0;
+
+    if (src_format->format != dst_format->format || color_key
+            || src_format->to_rgba || src_format->from_rgba || src_format->bytes_per_pixel > 4)
+        return FALSE;
+
+    for (c = 0; c < 4; ++c)
+    {
+        if (src_format->bits[c] >= 32)
+            return FALSE;
+        bits += src_format->bits[c];
+    }
+    return bits == src_format->bytes_per_pixel * 8;
+}
+
 /************************************************************
  * copy_pixels
  *
@@ -1646,6 +1666,7 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
     DWORD channels[4];
     UINT min_width, min_height, min_depth;
     UINT x, y, z;
+    BOOL identity;
 
     TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
             "dst_row_pitch %u, dst_slice_pitch %u, dst_size %p, dst_format %p, color_key 0x%08x, palette %p.\n",
@@ -1654,6 +1675,7 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
 
     ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
+    identity = is_identity_conversion(src_format, dst_format, color_key);
 
     min_width = min(src_size->width, dst_size->width);
     min_height = min(src_size->height, dst_size->height);
@@ -1674,7 +1696,12 @@ void convert_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slice_pit
             const BYTE *src_ptr = src_slice_ptr + y * src_row_pitch;
             BYTE *dst_ptr = dst_slice_ptr + y * dst_row_pitch;
 
-            for (x = 0; x < min_width; x++) {
+            if (identity)
+            {
+                memcpy(dst_ptr, src_ptr, min_width * src_format->bytes_per_pixel);
+                dst_ptr += min_width * dst_format->bytes_per_pixel;
+            }
+            else for (x = 0; x < min_width; x++) {
                 if (!src_format->to_rgba && !dst_format->from_rgba
                         && src_format->type == dst_format->type
                         && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
@@ -1753,6 +1780,7 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
     const struct pixel_format_desc *ck_format = NULL;
     DWORD channels[4];
     UINT x, y, z;
+    BOOL identity;
 
     TRACE("src %p, src_row_pitch %u, src_slice_pitch %u, src_size %p, src_format %p, dst %p, "
             "dst_row_pitch %u, dst_slice_pitch %u, dst_size %p, dst_format %p, color_key 0x%08x, palette %p.\n",
@@ -1761,6 +1789,7 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
 
     ZeroMemory(channels, sizeof(channels));
     init_argb_conversion_info(src_format, dst_format, &conv_info);
+    identity = is_identity_conversion(src_format, dst_format, color_key);
 
     if (color_key)
     {
@@ -1783,7 +1812,11 @@ void point_filter_argb_pixels(const BYTE *src, UINT src_row_pitch, UINT src_slic
             {
                 const BYTE *src_ptr = src_row_ptr + (x * src_size->width / dst_size->width) * src_format->bytes_per_pixel;
 
-                if (!src_format->to_rgba && !dst_format->from_rgba
+                if (identity)
+                {
+                    memcpy(dst_ptr, src_ptr, dst_format->bytes_per_pixel);
+                }
+                else if (!src_format->to_rgba && !dst_format->from_rgba
                         && src_format->type == dst_format->type
                         && src_format->bytes_per_pixel <= 4 && dst_format->bytes_per_pixel <= 4)
                 {
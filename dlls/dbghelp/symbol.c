@@ -760,26 +760,6 @@ static BOOL symt_enum_module(struct module_pair* pair, const WCHAR* match,
     return FALSE;
 }
 
-static inline unsigned where_to_insert(struct module* module, unsigned high, const struct symt_ht* elt)
-{
-    unsigned    low = 0, mid = high / 2;
-    ULONG64     addr;
-
-    if (!high) return 0;
-    symt_get_address(&elt->symt, &addr);
-    do
-    {
-        switch (cmp_sorttab_addr(module, mid, addr))
-        {
-        case 0: return mid;
-        case -1: low = mid + 1; break;
-        case 1: high = mid; break;
-        }
-        mid = low + (high - low) / 2;
-    } while (low < high);
-    return mid;
-}
-
 /***********************************************************************
  *              resort_symbols
  *
@@ -797,10 +777,12 @@ static BOOL resort_symbols(struct module* module)
      * (unless the first set is empty)
      */
     delta = module->num_symbols - module->num_sorttab;
-    qsort(&module->addr_sorttab[module->num_sorttab], delta, sizeof(struct symt_ht*), symt_cmp_addr);
-    if (module->num_sorttab)
+    if (!module->num_sorttab)
+        qsort(module->addr_sorttab, delta, sizeof(struct symt_ht*), symt_cmp_addr);
+    else
     {
-        int     i, ins_idx = module->num_sorttab, prev_ins_idx;
+        int     i, j, k;
+        ULONG64 addr_i, addr_j;
         static struct symt_ht** tmp;
         static unsigned num_tmp;
 
@@ -822,14 +804,17 @@ static BOOL resort_symbols(struct module* module)
         memcpy(tmp, &module->addr_sorttab[module->num_sorttab], delta * sizeof(struct symt_ht*));
         qsort(tmp, delta, sizeof(struct symt_ht*), symt_cmp_addr);
 
-        for (i = delta - 1; i >= 0; i--)
+        /* merge from the end, so that the old set can be moved in place */
+        i = module->num_sorttab - 1;
+        k = module->num_symbols - 1;
+        for (j = delta - 1; j >= 0; k--)
         {
-            prev_ins_idx = ins_idx;
-            ins_idx = where_to_insert(module, ins_idx, tmp[i]);
-            memmove(&module->addr_sorttab[ins_idx + i + 1],
-                    &module->addr_sorttab[ins_idx],
-                    (prev_ins_idx - ins_idx) * sizeof(struct symt_ht*));
-            module->addr_sorttab[ins_idx + i] = tmp[i];
+            symt_get_address(&tmp[j]->symt, &addr_j);
+            if (i >= 0 && symt_get_address(&module->addr_sorttab[i]->symt, &addr_i) &&
+                addr_i > addr_j)
+                module->addr_sorttab[k] = module->addr_sorttab[i--];
+            else
+                module->addr_sorttab[k] = tmp[j--];
         }
     }
     module->num_sorttab = module->num_symbols;
@@ -275,29 +275,41 @@ void DSOUND_CheckEvent(const IDirectSoundBufferImpl *dsb, DWORD playpos, int len
     }
 }
 
+/* Callers step mixpos by whole frames, so it only needs wrapping when it
+ * crosses the end of a looping buffer. */
+static inline DWORD wrap_mixpos(const IDirectSoundBufferImpl *dsb, DWORD mixpos)
+{
+    if (mixpos >= dsb->buflen && (dsb->playflags & DSBPLAY_LOOPING))
+        mixpos %= dsb->buflen;
+    return mixpos;
+}
+
 static inline float get_current_sample(const IDirectSoundBufferImpl *dsb,
         DWORD mixpos, DWORD channel)
 {
-    if (mixpos >= dsb->buflen && !(dsb->playflags & DSBPLAY_LOOPING))
+    if (mixpos >= dsb->buflen)
         return 0.0f;
-    return dsb->get(dsb, mixpos % dsb->buflen, channel);
+    return dsb->get(dsb, mixpos, channel);
 }
 
 static UINT cp_fields_noresample(IDirectSoundBufferImpl *dsb, UINT count)
 {
     UINT istride = dsb->pwfx->nBlockAlign;
     UINT ostride = dsb->device->pwfx->nChannels * sizeof(float);
-    DWORD channel, i;
-    for (i = 0; i < count; i++)
+    DWORD channel, i, mixpos = dsb->sec_mixpos;
+    for (i = 0; i < count; i++, mixpos += istride)
+    {
+        mixpos = wrap_mixpos(dsb, mixpos);
         for (channel = 0; channel < dsb->mix_channels; channel++)
-            dsb->put(dsb, i * ostride, channel, get_current_sample(dsb,
-                    dsb->sec_mixpos + i * istride, channel));
+            dsb->put(dsb, i * ostride, channel, get_current_sample(dsb, mixpos, channel));
+    }
     return count;
 }
 
 static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *freqAccNum)
 {
     UINT i, channel;
+    DWORD mixpos;
     UINT istride = dsb->pwfx->nBlockAlign;
     UINT ostride = dsb->device->pwfx->nChannels * sizeof(float);
 
@@ -333,9 +345,14 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
      */
     itmp = intermediate;
     for (channel = 0; channel < channels; channel++)
-        for (i = 0; i < required_input; i++)
-            *(itmp++) = get_current_sample(dsb,
-                    dsb->sec_mixpos + i * istride, channel);
+    {
+        mixpos = dsb->sec_mixpos;
+        for (i = 0; i < required_input; i++, mixpos += istride)
+        {
+            mixpos = wrap_mixpos(dsb, mixpos);
+            *(itmp++) = get_current_sample(dsb, mixpos, channel);
+        }
+    }
 
     for(i = 0; i < count; ++i) {
         UINT int_fir_steps = (freqAcc_start + i * dsb->freqAdjustNum) * dsbfirstep / dsb->freqAdjustDen;
@@ -356,11 +373,19 @@ static UINT cp_fields_resample(IDirectSoundBufferImpl *dsb, UINT count, LONG64 *
 
         for (channel = 0; channel < dsb->mix_channels; channel++) {
             int j;
-            float sum = 0.0;
+            float sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
             float* cache = &intermediate[channel * required_input + ipos];
-            for (j = 0; j < fir_used; j++)
-                sum += fir_copy[j] * cache[j];
-            dsb->put(dsb, i * ostride, channel, sum * dsb->firgain);
+            /* independent partial sums let the compiler vectorize this */
+            for (j = 0; j + 4 <= fir_used; j += 4)
+            {
+                sum0 += fir_copy[j] * cache[j];
+                sum1 += fir_copy[j + 1] * cache[j + 1];
+                sum2 += fir_copy[j + 2] * cache[j + 2];
+                sum3 += fir_copy[j + 3] * cache[j + 3];
+            }
+            for (; j < fir_used; j++)
+                sum0 += fir_copy[j] * cache[j];
+            dsb->put(dsb, i * ostride, channel, ((sum0 + sum1) + (sum2 + sum3)) * dsb->firgain);
         }
     }
 
@@ -434,7 +459,7 @@ static void DSOUND_MixToTemporary(IDirectSoundBufferImpl *dsb, DWORD frames)
 			dsb->device->tmp_buffer = HeapAlloc(GetProcessHeap(), 0, size_bytes);
 	}
 	if(dsb->put_aux == putieee32_sum)
-		memset(dsb->device->tmp_buffer, 0, dsb->device->tmp_buffer_len);
+		memset(dsb->device->tmp_buffer, 0, size_bytes);
 
 	cp_fields(dsb, frames, &dsb->freqAccNum);
 
@@ -2572,6 +2572,7 @@ static inline HRESULT return_range(const struct layout_range_header *h, DWRITE_T
 static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layout_range_attr_kind attr, struct layout_range_attr_value *value)
 {
     struct layout_range_header *cur, *right, *left, *outer;
+    USHORT recompute = RECOMPUTE_EVERYTHING;
     BOOL changed = FALSE;
     struct list *ranges;
     DWRITE_TEXT_RANGE r;
@@ -2596,12 +2597,16 @@ static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layo
         break;
     case LAYOUT_RANGE_ATTR_UNDERLINE:
         ranges = &layout->underline_ranges;
+        /* decorations and effects only split runs into effective runs */
+        recompute = RECOMPUTE_LINES_AND_OVERHANGS;
         break;
     case LAYOUT_RANGE_ATTR_STRIKETHROUGH:
         ranges = &layout->strike_ranges;
+        recompute = RECOMPUTE_LINES_AND_OVERHANGS;
         break;
     case LAYOUT_RANGE_ATTR_EFFECT:
         ranges = &layout->effects;
+        recompute = RECOMPUTE_LINES_AND_OVERHANGS;
         break;
     case LAYOUT_RANGE_ATTR_SPACING:
         ranges = &layout->spacing;
@@ -2672,7 +2677,7 @@ static HRESULT set_layout_range_attr(struct dwrite_textlayout *layout, enum layo
         list_add_after(&outer->entry, &cur->entry);
         list_add_after(&cur->entry, &right->entry);
 
-        layout->recompute = RECOMPUTE_EVERYTHING;
+        layout->recompute |= recompute;
         return S_OK;
     }
 
@@ -2712,7 +2717,7 @@ done:
     if (changed) {
         struct list *next, *i;
 
-        layout->recompute = RECOMPUTE_EVERYTHING;
+        layout->recompute |= recompute;
         i = list_head(ranges);
         while ((next = list_next(ranges, i))) {
             struct layout_range_header *next_range = LIST_ENTRY(next, struct layout_range_header, entry);
@@ -416,6 +416,42 @@ static GpStatus alpha_blend_bmp_pixels(GpGraphics *graphics, INT dst_x, INT dst_
 
     GdipGetCompositingMode(graphics, &comp_mode);
 
+    if (dst_bitmap->format == PixelFormat32bppARGB)
+    {
+        /* Access the destination bits directly, skipping pixels outside of
+         * the bitmap just like GdipBitmapSetPixel does. */
+        for (y=0; y<src_height; y++)
+        {
+            const ARGB *src_row = (const ARGB*)(src + src_stride * y);
+            ARGB *dst_row;
+
+            if (y + dst_y < 0 || y + dst_y >= dst_bitmap->height)
+                continue;
+
+            dst_row = (ARGB*)(dst_bitmap->bits + dst_bitmap->stride * (y + dst_y));
+
+            for (x=0; x<src_width; x++)
+            {
+                ARGB src_color = src_row[x];
+
+                if (x + dst_x < 0 || x + dst_x >= dst_bitmap->width)
+                    continue;
+
+                if (comp_mode == CompositingModeSourceCopy)
+                    dst_row[x + dst_x] = (src_color & 0xff000000) ? src_color : 0;
+                else if (src_color & 0xff000000)
+                {
+                    if (fmt & PixelFormatPAlpha)
+                        dst_row[x + dst_x] = color_over_fgpremult(dst_row[x + dst_x], src_color);
+                    else
+                        dst_row[x + dst_x] = color_over(dst_row[x + dst_x], src_color);
+                }
+            }
+        }
+
+        return Ok;
+    }
+
     for (y=0; y<src_height; y++)
     {
         for (x=0; x<src_width; x++)
@@ -3246,9 +3282,9 @@ GpStatus WINGDIPAPI GdipDrawImagePointsRect(GpGraphics *graphics, GpImage *image
                 y_dx = dst_to_src_points[2].X - dst_to_src_points[0].X;
                 y_dy = dst_to_src_points[2].Y - dst_to_src_points[0].Y;
 
-                for (x=dst_area.left; x<dst_area.right; x++)
+                for (y=dst_area.top; y<dst_area.bottom; y++)
                 {
-                    for (y=dst_area.top; y<dst_area.bottom; y++)
+                    for (x=dst_area.left; x<dst_area.right; x++)
                     {
                         GpPointF src_pointf;
                         ARGB *dst_color;
@@ -2480,6 +2480,15 @@ static unsigned int get_weight( WCHAR ch, enum weight type )
 }
 
 
+/* ASCII letters and digits have no decomposition, are not symbols, hyphens
+ * or apostrophes, and have non-zero weights at every level, so
+ * compare_weights() always steps over them in both strings at once. */
+static inline BOOL is_simple_sort_char( WCHAR ch )
+{
+    return (ch >= '0' && ch <= '9') || ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'z');
+}
+
+
 static void inc_str_pos( const WCHAR **str, int *len, unsigned int *dpos, unsigned int *dlen )
 {
     (*dpos)++;
@@ -3049,6 +3058,23 @@ INT WINAPI CompareStringEx( const WCHAR *locale, DWORD flags, const WCHAR *str1,
     if (len1 < 0) len1 = lstrlenW(str1);
     if (len2 < 0) len2 = lstrlenW(str2);
 
+    /* skip the common prefix that compares equal at every level */
+    while (len1 && len2 && *str1 == *str2 && is_simple_sort_char( *str1 ))
+    {
+        str1++;
+        str2++;
+        len1--;
+        len2--;
+    }
+    if (!len1 && !len2) return CSTR_EQUAL;
+
+    /* the first differing characters decide if their unicode weights differ */
+    if (len1 && len2 && is_simple_sort_char( *str1 ) && is_simple_sort_char( *str2 ))
+    {
+        ret = get_weight( *str1, UNICODE_WEIGHT ) - get_weight( *str2, UNICODE_WEIGHT );
+        if (ret) return (ret < 0) ? CSTR_LESS_THAN : CSTR_GREATER_THAN;
+    }
+
     ret = compare_weights( flags, str1, len1, str2, len2, UNICODE_WEIGHT );
     if (!ret)
     {
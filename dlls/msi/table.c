@@ -40,13 +40,23 @@ WINE_DEFAULT_DEBUG_CHANNEL(msidb);
 
 #define MSITABLE_HASH_TABLE_SIZE 37
 
+#define MSITABLE_HASH_NO_ROW (~0u)
+
+/* hash table entries are indexed by row, rows with the same hash are chained in increasing order */
 typedef struct tagMSICOLUMNHASHENTRY
 {
-    struct tagMSICOLUMNHASHENTRY *next;
     UINT value;
-    UINT row;
+    UINT next;
 } MSICOLUMNHASHENTRY;
 
+typedef struct tagMSICOLUMNHASHTABLE
+{
+    UINT bucket_count;
+    UINT entry_count;
+    UINT *buckets;
+    MSICOLUMNHASHENTRY *entries;
+} MSICOLUMNHASHTABLE;
+
 typedef struct tagMSICOLUMNINFO
 {
     LPCWSTR tablename;
@@ -54,7 +64,7 @@ typedef struct tagMSICOLUMNINFO
     LPCWSTR colname;
     UINT    type;
     UINT    offset;
-    MSICOLUMNHASHENTRY **hash_table;
+    MSICOLUMNHASHTABLE *hash_table;
 } MSICOLUMNINFO;
 
 struct tagMSITABLE
@@ -354,10 +364,85 @@ end:
     return ret;
 }
 
+static void free_column_hash_table( MSICOLUMNINFO *info )
+{
+    if (!info->hash_table) return;
+    msi_free( info->hash_table->buckets );
+    msi_free( info->hash_table->entries );
+    msi_free( info->hash_table );
+    info->hash_table = NULL;
+}
+
 static void msi_free_colinfo( MSICOLUMNINFO *colinfo, UINT count )
 {
     UINT i;
-    for (i = 0; i < count; i++) msi_free( colinfo[i].hash_table );
+    for (i = 0; i < count; i++) free_column_hash_table( &colinfo[i] );
+}
+
+static void free_hash_tables( MSITABLE *table )
+{
+    msi_free_colinfo( table->colinfo, table->col_count );
+}
+
+static void hash_table_link_row( MSICOLUMNHASHTABLE *hash_table, UINT row )
+{
+    UINT *next = &hash_table->buckets[hash_table->entries[row].value % hash_table->bucket_count];
+
+    while (*next != MSITABLE_HASH_NO_ROW && *next < row)
+        next = &hash_table->entries[*next].next;
+
+    hash_table->entries[row].next = *next;
+    *next = row;
+}
+
+static void hash_table_unlink_row( MSICOLUMNHASHTABLE *hash_table, UINT row )
+{
+    UINT *next = &hash_table->buckets[hash_table->entries[row].value % hash_table->bucket_count];
+
+    while (*next != MSITABLE_HASH_NO_ROW)
+    {
+        if (*next == row)
+        {
+            *next = hash_table->entries[row].next;
+            return;
+        }
+        next = &hash_table->entries[*next].next;
+    }
+}
+
+/* Make room for a new unlinked row, renumbering the rows after it.
+ * Returns FALSE if the hash table has to be rebuilt. */
+static BOOL hash_table_insert_row( MSICOLUMNHASHTABLE *hash_table, UINT row, UINT row_count )
+{
+    UINT i;
+
+    /* keep the chains short, rebuild with more buckets when the table has grown a lot */
+    if (row_count > 4 * hash_table->bucket_count)
+        return FALSE;
+
+    if (row_count > hash_table->entry_count)
+    {
+        UINT count = max( row_count, hash_table->entry_count * 2 );
+        MSICOLUMNHASHENTRY *entries;
+
+        if (!(entries = msi_realloc( hash_table->entries, count * sizeof(*entries) )))
+            return FALSE;
+        hash_table->entries = entries;
+        hash_table->entry_count = count;
+    }
+
+    memmove( &hash_table->entries[row + 1], &hash_table->entries[row],
+             (row_count - 1 - row) * sizeof(*hash_table->entries) );
+    hash_table->entries[row].next = MSITABLE_HASH_NO_ROW;
+
+    for (i = 0; i < hash_table->bucket_count; i++)
+        if (hash_table->buckets[i] != MSITABLE_HASH_NO_ROW && hash_table->buckets[i] >= row)
+            hash_table->buckets[i]++;
+    for (i = 0; i < row_count; i++)
+        if (hash_table->entries[i].next != MSITABLE_HASH_NO_ROW && hash_table->entries[i].next >= row)
+            hash_table->entries[i].next++;
+
+    return TRUE;
 }
 
 static void free_table( MSITABLE *table )
@@ -1157,6 +1242,7 @@ static UINT TABLE_fetch_stream( struct tagMSIVIEW *view, UINT row, UINT col, ISt
 /* Set a table value, i.e. preadjusted integer or string ID. */
 static UINT table_set_bytes( MSITABLEVIEW *tv, UINT row, UINT col, UINT val )
 {
+    MSICOLUMNHASHTABLE *hash_table;
     UINT offset, n, i;
 
     if( !tv->table )
@@ -1175,9 +1261,6 @@ static UINT table_set_bytes( MSITABLEVIEW *tv, UINT row, UINT col, UINT val )
         return ERROR_FUNCTION_FAILED;
     }
 
-    msi_free( tv->columns[col-1].hash_table );
-    tv->columns[col-1].hash_table = NULL;
-
     n = bytes_per_column( tv->db, &tv->columns[col - 1], LONG_STR_BYTES );
     if ( n != 2 && n != 3 && n != 4 )
     {
@@ -1185,10 +1268,20 @@ static UINT table_set_bytes( MSITABLEVIEW *tv, UINT row, UINT col, UINT val )
         return ERROR_FUNCTION_FAILED;
     }
 
+    hash_table = col <= tv->table->col_count ? tv->table->colinfo[col-1].hash_table : NULL;
+    if (hash_table)
+        hash_table_unlink_row( hash_table, row );
+
     offset = tv->columns[col-1].offset;
     for ( i = 0; i < n; i++ )
         tv->table->data[row][offset + i] = (val >> i * 8) & 0xff;
 
+    if (hash_table)
+    {
+        hash_table->entries[row].value = read_table_int( tv->table->data, row, offset, n );
+        hash_table_link_row( hash_table, row );
+    }
+
     return ERROR_SUCCESS;
 }
 
@@ -1734,6 +1827,23 @@ static UINT TABLE_insert_row( struct tagMSIVIEW *view, MSIRECORD *rec, UINT row,
 
     /* Re-set the persistence flag */
     tv->table->data_persistent[row] = !temporary;
+
+    /* renumber the rows in the hash tables and add the new row with its current
+     * contents, setting its values below moves it to the right chain */
+    for (i = 0; i < tv->table->col_count; i++)
+    {
+        MSICOLUMNHASHTABLE *hash_table = tv->table->colinfo[i].hash_table;
+
+        if (!hash_table) continue;
+        if (!hash_table_insert_row( hash_table, row, tv->table->row_count ) ||
+            TABLE_fetch_int( view, row, i + 1, &hash_table->entries[row].value ) != ERROR_SUCCESS)
+        {
+            free_column_hash_table( &tv->table->colinfo[i] );
+            continue;
+        }
+        hash_table_link_row( hash_table, row );
+    }
+
     return TABLE_set_row( view, row, rec, (1<<tv->num_cols) - 1 );
 }
 
@@ -1758,11 +1868,7 @@ static UINT TABLE_delete_row( struct tagMSIVIEW *view, UINT row )
     tv->table->row_count--;
 
     /* reset the hash tables */
-    for (i = 0; i < tv->num_cols; i++)
-    {
-        msi_free( tv->columns[i].hash_table );
-        tv->columns[i].hash_table = NULL;
-    }
+    free_hash_tables( tv->table );
 
     for (i = row + 1; i < num_rows; i++)
     {
@@ -1946,6 +2052,7 @@ static UINT TABLE_remove_column(struct tagMSIVIEW *view, UINT number)
     if (tv->table->colinfo[number-1].type & MSITYPE_TEMPORARY)
     {
         UINT size = tv->table->colinfo[number-1].offset;
+        free_column_hash_table( &tv->table->colinfo[number-1] );
         tv->table->col_count--;
         tv->table->colinfo = msi_realloc( tv->table->colinfo, sizeof(*tv->table->colinfo) * tv->table->col_count );
 
@@ -3144,13 +3251,80 @@ static UINT msi_row_matches( MSITABLEVIEW *tv, UINT row, const UINT *data, UINT
     return ret;
 }
 
+/* build the hash table of a column, chaining the rows with the same value in increasing order */
+static MSICOLUMNHASHTABLE *get_column_hash_table( MSITABLEVIEW *tv, UINT col )
+{
+    MSICOLUMNINFO *info = &tv->table->colinfo[col];
+    UINT i, value, row_count = tv->table->row_count;
+    MSICOLUMNHASHTABLE *hash_table;
+
+    if (info->hash_table) return info->hash_table;
+
+    if (!(hash_table = msi_alloc( sizeof(*hash_table) )))
+        return NULL;
+    hash_table->bucket_count = max( MSITABLE_HASH_TABLE_SIZE, (row_count / 2) | 1 );
+    hash_table->entry_count = row_count;
+    hash_table->buckets = msi_alloc( hash_table->bucket_count * sizeof(*hash_table->buckets) );
+    hash_table->entries = msi_alloc( row_count * sizeof(*hash_table->entries) );
+    info->hash_table = hash_table;
+    if (!hash_table->buckets || !hash_table->entries)
+    {
+        free_column_hash_table( info );
+        return NULL;
+    }
+
+    for (i = 0; i < hash_table->bucket_count; i++)
+        hash_table->buckets[i] = MSITABLE_HASH_NO_ROW;
+
+    for (i = row_count; i > 0; i--)
+    {
+        if (TABLE_fetch_int( &tv->view, i - 1, col + 1, &value ) != ERROR_SUCCESS)
+        {
+            free_column_hash_table( info );
+            return NULL;
+        }
+        hash_table->entries[i - 1].value = value;
+        hash_table->entries[i - 1].next = hash_table->buckets[value % hash_table->bucket_count];
+        hash_table->buckets[value % hash_table->bucket_count] = i - 1;
+    }
+
+    TRACE("built hash table for column %s of %s, %u rows\n",
+          debugstr_w(info->colname), debugstr_w(tv->name), row_count);
+    return hash_table;
+}
+
 static UINT msi_table_find_row( MSITABLEVIEW *tv, MSIRECORD *rec, UINT *row, UINT *column )
 {
     UINT i, r = ERROR_FUNCTION_FAILED, *data;
+    MSICOLUMNHASHTABLE *hash_table;
 
     data = msi_record_to_row( tv, rec );
     if( !data )
         return r;
+
+    /* use the first key column to find candidate rows in large tables */
+    for( i = 0; i < tv->num_cols; i++ )
+        if ( tv->columns[i].type & MSITYPE_KEY ) break;
+
+    if( i < tv->table->col_count && tv->table->row_count > MSITABLE_HASH_TABLE_SIZE &&
+        (hash_table = get_column_hash_table( tv, i )) )
+    {
+        UINT next = hash_table->buckets[data[i] % hash_table->bucket_count];
+
+        for( ; next != MSITABLE_HASH_NO_ROW; next = hash_table->entries[next].next )
+        {
+            if( hash_table->entries[next].value != data[i] ) continue;
+            r = msi_row_matches( tv, next, data, column );
+            if( r == ERROR_SUCCESS )
+            {
+                *row = next;
+                break;
+            }
+        }
+        msi_free( data );
+        return r;
+    }
+
     for( i = 0; i < tv->table->row_count; i++ )
     {
         r = msi_row_matches( tv, i, data, column );
@@ -8799,6 +8799,56 @@ static void test_primary_keys(void)
     DeleteFileA(msifile);
 }
 
+static void test_many_rows(void)
+{
+    MSIHANDLE hdb, hview, hrec;
+    char query[100];
+    UINT r, i, count;
+
+    hdb = create_db();
+
+    r = run_query(hdb, 0, "CREATE TABLE `T` (`A` SHORT, `B` SHORT, `C` SHORT PRIMARY KEY `A`, `B`)");
+    ok(!r, "got %u\n", r);
+
+    /* rows are kept sorted, so most of these are inserted in the middle of the table */
+    for (i = 0; i < 200; i++)
+    {
+        sprintf(query, "INSERT INTO `T` (`A`, `B`, `C`) VALUES (%u, %u, %u)", (i * 7) % 50, i, i);
+        r = run_query(hdb, 0, query);
+        ok(!r, "%u: got %u\n", i, r);
+    }
+
+    for (i = 0; i < 200; i += 13)
+    {
+        sprintf(query, "INSERT INTO `T` (`A`, `B`, `C`) VALUES (%u, %u, 1000)", (i * 7) % 50, i);
+        r = run_query(hdb, 0, query);
+        ok(r == ERROR_FUNCTION_FAILED, "%u: got %u\n", i, r);
+
+        sprintf(query, "SELECT `C` FROM `T` WHERE `A` = %u AND `B` = %u", (i * 7) % 50, i);
+        r = do_query(hdb, query, &hrec);
+        ok(!r, "%u: got %u\n", i, r);
+        ok(MsiRecordGetInteger(hrec, 1) == i, "%u: got %d\n", i, MsiRecordGetInteger(hrec, 1));
+        MsiCloseHandle(hrec);
+    }
+
+    r = MsiDatabaseOpenViewA(hdb, "SELECT * FROM `T`", &hview);
+    ok(!r, "got %u\n", r);
+    r = MsiViewExecute(hview, 0);
+    ok(!r, "got %u\n", r);
+    count = 0;
+    while (!MsiViewFetch(hview, &hrec))
+    {
+        count++;
+        MsiCloseHandle(hrec);
+    }
+    ok(count == 200, "got %u rows\n", count);
+    MsiViewClose(hview);
+    MsiCloseHandle(hview);
+
+    MsiCloseHandle(hdb);
+    DeleteFileA(msifile);
+}
+
 static void test_viewmodify_merge(void)
 {
     MSIHANDLE view, rec, db = create_db();
@@ -9331,6 +9381,7 @@ START_TEST(db)
     test_embedded_nulls();
     test_select_column_names();
     test_primary_keys();
+    test_many_rows();
     test_viewmodify_merge();
     test_viewmodify_insert();
     test_view_get_error();
@@ -561,6 +561,57 @@ RUNTIME_FUNCTION *lookup_function_info( ULONG_PTR pc, ULONG_PTR *base, LDR_DATA_
     return func;
 }
 
+#ifdef __x86_64__
+
+/**********************************************************************
+ *           lookup_function_info_history
+ *
+ * Same as lookup_function_info(), but first tries the entries cached in
+ * the unwind history table, and caches the result there.
+ */
+RUNTIME_FUNCTION *lookup_function_info_history( ULONG_PTR pc, ULONG_PTR *base,
+                                                LDR_DATA_TABLE_ENTRY **module,
+                                                UNWIND_HISTORY_TABLE *table )
+{
+    RUNTIME_FUNCTION *func;
+    ULONG_PTR start, end;
+    ULONG i, count;
+
+    if (table && table->Count && pc >= table->LowAddress && pc < table->HighAddress)
+    {
+        /* the table is supplied by the caller, don't trust its count */
+        count = min( table->Count, UNWIND_HISTORY_TABLE_SIZE );
+        for (i = 0; i < count; i++)
+        {
+            func = table->Entry[i].FunctionEntry;
+            if (pc >= table->Entry[i].ImageBase + func->BeginAddress &&
+                pc < table->Entry[i].ImageBase + func->EndAddress)
+            {
+                *base = table->Entry[i].ImageBase;
+                *module = NULL;
+                return func;
+            }
+        }
+    }
+
+    if (!(func = lookup_function_info( pc, base, module ))) return NULL;
+    if (!table || table->Count >= UNWIND_HISTORY_TABLE_SIZE) return func;
+
+    /* a chained entry was resolved to its primary entry, which doesn't cover pc */
+    start = *base + func->BeginAddress;
+    end = *base + func->EndAddress;
+    if (pc < start || pc >= end) return func;
+
+    if (!table->Count || start < table->LowAddress) table->LowAddress = start;
+    if (!table->Count || end > table->HighAddress) table->HighAddress = end;
+    table->Entry[table->Count].ImageBase = *base;
+    table->Entry[table->Count].FunctionEntry = func;
+    table->Count++;
+    return func;
+}
+
+#endif  /* __x86_64__ */
+
 /**********************************************************************
  *              RtlLookupFunctionEntry   (NTDLL.@)
  */
@@ -570,9 +621,11 @@ PRUNTIME_FUNCTION WINAPI RtlLookupFunctionEntry( ULONG_PTR pc, ULONG_PTR *base,
     LDR_DATA_TABLE_ENTRY *module;
     RUNTIME_FUNCTION *func;
 
-    /* FIXME: should use the history table to make things faster */
-
+#ifdef __x86_64__
+    if (!(func = lookup_function_info_history( pc, base, &module, table )))
+#else
     if (!(func = lookup_function_info( pc, base, &module )))
+#endif
     {
         *base = 0;
         WARN( "no exception table found for %lx\n", pc );
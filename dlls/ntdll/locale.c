@@ -1375,6 +1375,22 @@ found:
 }
 
 
+/* check whether the next 8 bytes of a UTF-8 string are all 7-bit ASCII */
+static inline BOOL is_ascii_utf8_block( const char *src )
+{
+    ULONG64 val;
+    memcpy( &val, src, sizeof(val) );
+    return !(val & 0x8080808080808080ull);
+}
+
+/* check whether the next 4 characters of a UTF-16 string are all 7-bit ASCII */
+static inline BOOL is_ascii_utf16_block( const WCHAR *src )
+{
+    ULONG64 val;
+    memcpy( &val, src, sizeof(val) );
+    return !(val & 0xff80ff80ff80ff80ull);
+}
+
 /* helper for the various utf8 mbstowcs functions */
 static unsigned int decode_utf8_char( unsigned char ch, const char **str, const char *strend )
 {
@@ -1448,7 +1464,16 @@ NTSTATUS WINAPI RtlUTF8ToUnicodeN( WCHAR *dst, DWORD dstlen, DWORD *reslen, cons
         for (len = 0; src < srcend; len++)
         {
             unsigned char ch = *src++;
-            if (ch < 0x80) continue;
+            if (ch < 0x80)
+            {
+                /* count the rest of an ASCII run 8 bytes at a time */
+                while (srcend - src >= 8 && is_ascii_utf8_block( src ))
+                {
+                    src += 8;
+                    len += 8;
+                }
+                continue;
+            }
             if ((res = decode_utf8_char( ch, &src, srcend )) > 0x10ffff)
                 status = STATUS_SOME_NOT_MAPPED;
             else
@@ -1464,6 +1489,20 @@ NTSTATUS WINAPI RtlUTF8ToUnicodeN( WCHAR *dst, DWORD dstlen, DWORD *reslen, cons
         if (ch < 0x80)  /* special fast case for 7-bit ASCII */
         {
             *dst++ = ch;
+            /* convert the rest of an ASCII run 8 bytes at a time */
+            while (srcend - src >= 8 && dstend - dst >= 8 && is_ascii_utf8_block( src ))
+            {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = src[3];
+                dst[4] = src[4];
+                dst[5] = src[5];
+                dst[6] = src[6];
+                dst[7] = src[7];
+                src += 8;
+                dst += 8;
+            }
             continue;
         }
         if ((res = decode_utf8_char( ch, &src, srcend )) <= 0xffff)
@@ -1508,7 +1547,17 @@ NTSTATUS WINAPI RtlUnicodeToUTF8N( char *dst, DWORD dstlen, DWORD *reslen, const
     {
         for (len = 0; srclen; srclen--, src++)
         {
-            if (*src < 0x80) len++;  /* 0x00-0x7f: 1 byte */
+            if (*src < 0x80)  /* 0x00-0x7f: 1 byte */
+            {
+                len++;
+                /* count the rest of an ASCII run 4 characters at a time */
+                while (srclen > 4 && is_ascii_utf16_block( src + 1 ))
+                {
+                    src += 4;
+                    srclen -= 4;
+                    len += 4;
+                }
+            }
             else if (*src < 0x800) len += 2;  /* 0x80-0x7ff: 2 bytes */
             else
             {
@@ -1538,6 +1587,17 @@ NTSTATUS WINAPI RtlUnicodeToUTF8N( char *dst, DWORD dstlen, DWORD *reslen, const
         {
             if (dst > end - 1) break;
             *dst++ = ch;
+            /* convert the rest of an ASCII run 4 characters at a time */
+            while (srclen > 4 && end - dst >= 4 && is_ascii_utf16_block( src + 1 ))
+            {
+                dst[0] = src[1];
+                dst[1] = src[2];
+                dst[2] = src[3];
+                dst[3] = src[4];
+                src += 4;
+                srclen -= 4;
+                dst += 4;
+            }
             continue;
         }
         if (ch < 0x800)  /* 0x80-0x7ff: 2 bytes */
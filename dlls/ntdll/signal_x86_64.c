@@ -263,7 +263,8 @@ static NTSTATUS virtual_unwind( ULONG type, DISPATCHER_CONTEXT *dispatch, CONTEX
 
     /* first look for PE exception information */
 
-    if ((dispatch->FunctionEntry = lookup_function_info( context->Rip, &dispatch->ImageBase, &module )))
+    if ((dispatch->FunctionEntry = lookup_function_info_history( context->Rip, &dispatch->ImageBase,
+                                                                 &module, dispatch->HistoryTable )))
     {
         dispatch->LanguageHandler = RtlVirtualUnwind( type, dispatch->ImageBase, context->Rip,
                                                       dispatch->FunctionEntry, context,
@@ -430,6 +431,7 @@ static NTSTATUS call_stack_handlers( EXCEPTION_RECORD *rec, CONTEXT *orig_contex
     context = *orig_context;
     context.ContextFlags &= ~0x40; /* Clear xstate flag. */
 
+    table.Count            = 0;
     dispatch.TargetIp      = 0;
     dispatch.ContextRecord = &context;
     dispatch.HistoryTable  = &table;
@@ -1176,6 +1178,7 @@ void WINAPI RtlUnwindEx( PVOID end_frame, PVOID target_ip, EXCEPTION_RECORD *rec
     EXCEPTION_REGISTRATION_RECORD *teb_frame = NtCurrentTeb()->Tib.ExceptionList;
     EXCEPTION_RECORD record;
     DISPATCHER_CONTEXT dispatch;
+    UNWIND_HISTORY_TABLE local_table;
     CONTEXT new_context;
     NTSTATUS status;
     DWORD i;
@@ -1183,6 +1186,12 @@ void WINAPI RtlUnwindEx( PVOID end_frame, PVOID target_ip, EXCEPTION_RECORD *rec
     RtlCaptureContext( context );
     new_context = *context;
 
+    if (!table)
+    {
+        local_table.Count = 0;
+        table = &local_table;
+    }
+
     /* build an exception record, if we do not have one */
     if (!rec)
     {
@@ -1456,6 +1465,7 @@ USHORT WINAPI RtlCaptureStackBackTrace( ULONG skip, ULONG count, PVOID *buffer,
     TRACE( "(%u, %u, %p, %p)\n", skip, count, buffer, hash );
 
     RtlCaptureContext( &context );
+    table.Count            = 0;
     dispatch.TargetIp      = 0;
     dispatch.ContextRecord = &context;
     dispatch.HistoryTable  = &table;
@@ -2529,8 +2529,10 @@ static void test_dynamic_unwind(void)
 {
     static const int code_offset = 1024;
     char buf[2 * sizeof(RUNTIME_FUNCTION) + 4];
+    UNWIND_HISTORY_TABLE history;
     RUNTIME_FUNCTION *runtime_func, *func;
     ULONG_PTR table, base;
+    unsigned int i;
     void *growable_table;
     NTSTATUS status;
     DWORD count;
@@ -2559,6 +2561,22 @@ static void test_dynamic_unwind(void)
     ok( base == (ULONG_PTR)code_mem,
         "RtlLookupFunctionEntry returned invalid base, expected: %lx, got: %lx\n", (ULONG_PTR)code_mem, base );
 
+    /* Test with a history table, the second lookup may be satisfied from it */
+    memset( &history, 0, sizeof(history) );
+    for (i = 0; i < 2; i++)
+    {
+        base = 0xdeadbeef;
+        func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + code_offset + 8, &base, &history );
+        ok( func == runtime_func,
+            "%u: RtlLookupFunctionEntry didn't return expected function, expected: %p, got: %p\n", i, runtime_func, func );
+        ok( base == (ULONG_PTR)code_mem,
+            "%u: RtlLookupFunctionEntry returned invalid base, expected: %lx, got: %lx\n", i, (ULONG_PTR)code_mem, base );
+    }
+    base = 0xdeadbeef;
+    func = pRtlLookupFunctionEntry( (ULONG_PTR)code_mem + code_offset + 16, &base, &history );
+    ok( func == NULL,
+        "RtlLookupFunctionEntry returned unexpected function, expected: NULL, got: %p\n", func );
+
     /* Test RtlDeleteFunctionTable */
     ok( pRtlDeleteFunctionTable( runtime_func ),
         "RtlDeleteFunctionTable failed for runtime_func = %p (aligned)\n", runtime_func );
@@ -68,19 +68,6 @@ static RTL_CRITICAL_SECTION_DEBUG critsect_compl_debug =
       0, 0, { (DWORD_PTR)(__FILE__ ": threadpool_compl_cs") }
 };
 
-struct wait_work_item
-{
-    HANDLE Object;
-    HANDLE CancelEvent;
-    WAITORTIMERCALLBACK Callback;
-    PVOID Context;
-    ULONG Milliseconds;
-    ULONG Flags;
-    HANDLE CompletionEvent;
-    LONG DeleteCount;
-    int CallbackInProgress;
-};
-
 struct timer_queue;
 struct queue_timer
 {
@@ -173,6 +160,8 @@ struct threadpool_object
     LONG                    num_pending_callbacks;
     LONG                    num_running_callbacks;
     LONG                    num_associated_callbacks;
+    /* event signaled when the object is destroyed, used by RtlDeregisterWaitEx */
+    HANDLE                  completed_event;
     /* arguments for callback */
     union
     {
@@ -206,6 +195,10 @@ struct threadpool_object
             struct list     wait_entry;
             ULONGLONG       timeout;
             HANDLE          handle;
+            /* information for waits created through RtlRegisterWait */
+            DWORD           flags;
+            RTL_WAITORTIMERCALLBACKFUNC rtl_callback;
+            ULONG           rtl_timeout;
         } wait;
         struct
         {
@@ -302,6 +295,7 @@ struct waitqueue_bucket
     struct list             reserved;
     struct list             waiting;
     HANDLE                  update_event;
+    BOOL                    alertable;
 };
 
 /* global I/O completion queue object */
@@ -372,6 +366,10 @@ static inline struct threadpool_instance *impl_from_TP_CALLBACK_INSTANCE( TP_CAL
 
 static void CALLBACK threadpool_worker_proc( void *param );
 static void tp_object_submit( struct threadpool_object *object, BOOL signaled );
+static NTSTATUS tp_alloc_wait( TP_WAIT **out, PTP_WAIT_CALLBACK callback, PVOID userdata,
+                               TP_CALLBACK_ENVIRON *environment, DWORD flags );
+static void tp_object_cancel( struct threadpool_object *object );
+static BOOL object_is_finished( struct threadpool_object *object, BOOL group );
 static void tp_object_prepare_shutdown( struct threadpool_object *object );
 static BOOL tp_object_release( struct threadpool_object *object );
 static struct threadpool *default_threadpool = NULL;
@@ -553,71 +551,58 @@ static inline PLARGE_INTEGER get_nt_timeout( PLARGE_INTEGER pTime, ULONG timeout
     return pTime;
 }
 
-static void delete_wait_work_item(struct wait_work_item *wait_work_item)
-{
-    NtClose( wait_work_item->CancelEvent );
-    RtlFreeHeap( GetProcessHeap(), 0, wait_work_item );
-}
-
-static DWORD CALLBACK wait_thread_proc(LPVOID Arg)
+/***********************************************************************
+ *           rtl_wait_set    (internal)
+ *
+ * Arms a wait registered through RtlRegisterWait. TpSetWait reports a zero
+ * timeout as timed out without looking at the object, so check the object
+ * first in that case; this also consumes the signal of auto-reset objects.
+ * Waits executed in the wait queue thread are checked by that thread.
+ */
+static void rtl_wait_set( TP_WAIT *wait, HANDLE handle, ULONG milliseconds )
 {
-    struct wait_work_item *wait_work_item = Arg;
-    NTSTATUS status;
-    BOOLEAN alertable = (wait_work_item->Flags & WT_EXECUTEINIOTHREAD) != 0;
-    HANDLE handles[2] = { wait_work_item->Object, wait_work_item->CancelEvent };
+    struct threadpool_object *object = impl_from_TP_WAIT( wait );
     LARGE_INTEGER timeout;
-    HANDLE completion_event;
-
-    TRACE("\n");
 
-    while (TRUE)
+    if (!milliseconds && !(object->u.wait.flags & (WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD)) &&
+        NtWaitForSingleObject( handle, FALSE, get_nt_timeout( &timeout, 0 ) ) == STATUS_WAIT_0)
     {
-        status = NtWaitForMultipleObjects( 2, handles, TRUE, alertable,
-                                           get_nt_timeout( &timeout, wait_work_item->Milliseconds ) );
-        if (status == STATUS_WAIT_0 || status == STATUS_TIMEOUT)
-        {
-            BOOLEAN TimerOrWaitFired;
+        RtlEnterCriticalSection( &waitqueue.cs );
+        TpSetWait( wait, NULL, NULL );
+        object->u.wait.handle = handle;
+        RtlLeaveCriticalSection( &waitqueue.cs );
 
-            if (status == STATUS_WAIT_0)
-            {
-                TRACE( "object %p signaled, calling callback %p with context %p\n",
-                    wait_work_item->Object, wait_work_item->Callback,
-                    wait_work_item->Context );
-                TimerOrWaitFired = FALSE;
-            }
-            else
-            {
-                TRACE( "wait for object %p timed out, calling callback %p with context %p\n",
-                    wait_work_item->Object, wait_work_item->Callback,
-                    wait_work_item->Context );
-                TimerOrWaitFired = TRUE;
-            }
-            InterlockedExchange( &wait_work_item->CallbackInProgress, TRUE );
-            if (wait_work_item->CompletionEvent)
-            {
-                TRACE( "Work has been canceled.\n" );
-                break;
-            }
-            wait_work_item->Callback( wait_work_item->Context, TimerOrWaitFired );
-            InterlockedExchange( &wait_work_item->CallbackInProgress, FALSE );
-
-            if (wait_work_item->Flags & WT_EXECUTEONLYONCE)
-                break;
-        }
-        else if (status != STATUS_USER_APC)
-            break;
+        tp_object_submit( object, TRUE );
+        return;
     }
 
+    TpSetWait( wait, handle, get_nt_timeout( &timeout, milliseconds ) );
+}
 
-    if (InterlockedIncrement( &wait_work_item->DeleteCount ) == 2 )
-    {
-        completion_event = wait_work_item->CompletionEvent;
-        delete_wait_work_item( wait_work_item );
-        if (completion_event && completion_event != INVALID_HANDLE_VALUE)
-            NtSetEvent( completion_event, NULL );
-    }
+/***********************************************************************
+ *           rtl_wait_callback    (internal)
+ *
+ * Wait callback used for waits registered through RtlRegisterWait. Waits
+ * without WT_EXECUTEONLYONCE are rearmed once the callback returned, so
+ * that a signaled manual-reset object doesn't flood the pool with callbacks.
+ */
+static void CALLBACK rtl_wait_callback( TP_CALLBACK_INSTANCE *instance, void *userdata,
+                                        TP_WAIT *wait, TP_WAIT_RESULT result )
+{
+    struct threadpool_object *object = impl_from_TP_WAIT( wait );
 
-    return 0;
+    TRACE( "wait %p %s, calling callback %p with context %p\n", object,
+           result == WAIT_OBJECT_0 ? "signaled" : "timed out", object->u.wait.rtl_callback, userdata );
+
+    object->u.wait.rtl_callback( userdata, result != WAIT_OBJECT_0 );
+
+    if (object->u.wait.flags & WT_EXECUTEONLYONCE) return;
+
+    /* RtlDeregisterWaitEx resets the handle, don't rearm the wait in that case. */
+    RtlEnterCriticalSection( &waitqueue.cs );
+    if (object->u.wait.handle)
+        rtl_wait_set( wait, object->u.wait.handle, object->u.wait.rtl_timeout );
+    RtlLeaveCriticalSection( &waitqueue.cs );
 }
 
 /***********************************************************************
@@ -649,42 +634,31 @@ NTSTATUS WINAPI RtlRegisterWait(PHANDLE NewWaitObject, HANDLE Object,
                                 RTL_WAITORTIMERCALLBACKFUNC Callback,
                                 PVOID Context, ULONG Milliseconds, ULONG Flags)
 {
-    struct wait_work_item *wait_work_item;
+    struct threadpool_object *object;
+    TP_CALLBACK_ENVIRON environment;
     NTSTATUS status;
+    TP_WAIT *wait;
 
     TRACE( "(%p, %p, %p, %p, %d, 0x%x)\n", NewWaitObject, Object, Callback, Context, Milliseconds, Flags );
 
-    wait_work_item = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*wait_work_item) );
-    if (!wait_work_item)
-        return STATUS_NO_MEMORY;
+    /* The wait is handled by the shared wait queue threads instead of a
+     * dedicated thread per wait. */
+    memset( &environment, 0, sizeof(environment) );
+    environment.Version = 1;
+    environment.u.s.LongFunction = (Flags & WT_EXECUTELONGFUNCTION) != 0;
+    environment.u.s.Persistent   = (Flags & WT_EXECUTEINPERSISTENTTHREAD) != 0;
 
-    wait_work_item->Object = Object;
-    wait_work_item->Callback = Callback;
-    wait_work_item->Context = Context;
-    wait_work_item->Milliseconds = Milliseconds;
-    wait_work_item->Flags = Flags;
-    wait_work_item->CallbackInProgress = FALSE;
-    wait_work_item->DeleteCount = 0;
-    wait_work_item->CompletionEvent = NULL;
+    Flags &= (WT_EXECUTEONLYONCE | WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD);
+    status = tp_alloc_wait( &wait, rtl_wait_callback, Context, &environment, Flags );
+    if (status) return status;
 
-    status = NtCreateEvent( &wait_work_item->CancelEvent, EVENT_ALL_ACCESS, NULL, NotificationEvent, FALSE );
-    if (status != STATUS_SUCCESS)
-    {
-        RtlFreeHeap( GetProcessHeap(), 0, wait_work_item );
-        return status;
-    }
-
-    Flags = Flags & (WT_EXECUTEINIOTHREAD | WT_EXECUTEINPERSISTENTTHREAD |
-                     WT_EXECUTELONGFUNCTION | WT_TRANSFER_IMPERSONATION);
-    status = RtlQueueWorkItem( wait_thread_proc, wait_work_item, Flags );
-    if (status != STATUS_SUCCESS)
-    {
-        delete_wait_work_item( wait_work_item );
-        return status;
-    }
+    object = impl_from_TP_WAIT( wait );
+    object->u.wait.rtl_callback = Callback;
+    object->u.wait.rtl_timeout  = Milliseconds;
 
-    *NewWaitObject = wait_work_item;
-    return status;
+    *NewWaitObject = object;
+    rtl_wait_set( wait, Object, Milliseconds );
+    return STATUS_SUCCESS;
 }
 
 /***********************************************************************
@@ -702,52 +676,33 @@ NTSTATUS WINAPI RtlRegisterWait(PHANDLE NewWaitObject, HANDLE Object,
  */
 NTSTATUS WINAPI RtlDeregisterWaitEx(HANDLE WaitHandle, HANDLE CompletionEvent)
 {
-    struct wait_work_item *wait_work_item = WaitHandle;
+    struct threadpool_object *object = WaitHandle;
     NTSTATUS status;
-    HANDLE LocalEvent = NULL;
-    int CallbackInProgress;
 
     TRACE( "(%p %p)\n", WaitHandle, CompletionEvent );
 
     if (WaitHandle == NULL)
         return STATUS_INVALID_HANDLE;
 
-    InterlockedExchangePointer( &wait_work_item->CompletionEvent, INVALID_HANDLE_VALUE );
-    CallbackInProgress = wait_work_item->CallbackInProgress;
-    TRACE( "callback in progress %u\n", CallbackInProgress );
-    if (CompletionEvent == INVALID_HANDLE_VALUE || !CallbackInProgress)
-    {
-        status = NtCreateEvent( &LocalEvent, EVENT_ALL_ACCESS, NULL, NotificationEvent, FALSE );
-        if (status != STATUS_SUCCESS)
-            return status;
-        InterlockedExchangePointer( &wait_work_item->CompletionEvent, LocalEvent );
-    }
-    else if (CompletionEvent != NULL)
-    {
-        InterlockedExchangePointer( &wait_work_item->CompletionEvent, CompletionEvent );
-    }
-
-    NtSetEvent( wait_work_item->CancelEvent, NULL );
+    TpSetWait( (TP_WAIT *)object, NULL, NULL );
 
-    if (InterlockedIncrement( &wait_work_item->DeleteCount ) == 2 )
-    {
-        status = STATUS_SUCCESS;
-        delete_wait_work_item( wait_work_item );
-    }
-    else if (LocalEvent)
+    if (CompletionEvent == INVALID_HANDLE_VALUE)
     {
-        TRACE( "Waiting for completion event\n" );
-        NtWaitForSingleObject( LocalEvent, FALSE, NULL );
+        TRACE( "Waiting for completion\n" );
+        TpWaitForWait( (TP_WAIT *)object, TRUE );
         status = STATUS_SUCCESS;
     }
     else
     {
-        status = STATUS_PENDING;
-    }
+        tp_object_cancel( object );
+        object->completed_event = CompletionEvent;
 
-    if (LocalEvent)
-        NtClose( LocalEvent );
+        RtlEnterCriticalSection( &object->pool->cs );
+        status = object->num_running_callbacks ? STATUS_PENDING : STATUS_SUCCESS;
+        RtlLeaveCriticalSection( &object->pool->cs );
+    }
 
+    TpReleaseWait( (TP_WAIT *)object );
     return status;
 }
 
@@ -1451,17 +1406,57 @@ static void tp_timerqueue_unlock( struct threadpool_object *timer )
     RtlLeaveCriticalSection( &timerqueue.cs );
 }
 
+/***********************************************************************
+ *           waitqueue_execute_callback    (internal)
+ *
+ * Executes the callback of a wait registered with WT_EXECUTEINWAITTHREAD
+ * or WT_EXECUTEINIOTHREAD directly on the wait queue thread. Has to be
+ * called with waitqueue.cs held, which is released during the callback.
+ */
+static void waitqueue_execute_callback( struct threadpool_object *wait, TP_WAIT_RESULT result )
+{
+    struct threadpool *pool = wait->pool;
+
+    assert( wait->type == TP_OBJECT_TYPE_WAIT );
+
+    /* Wait was deregistered while the lock was released. */
+    if (!wait->u.wait.handle) return;
+
+    RtlEnterCriticalSection( &pool->cs );
+    InterlockedIncrement( &wait->refcount );
+    wait->num_associated_callbacks++;
+    wait->num_running_callbacks++;
+    RtlLeaveCriticalSection( &pool->cs );
+
+    RtlLeaveCriticalSection( &waitqueue.cs );
+    rtl_wait_callback( NULL, wait->userdata, (TP_WAIT *)wait, result );
+    RtlEnterCriticalSection( &waitqueue.cs );
+
+    RtlEnterCriticalSection( &pool->cs );
+    wait->num_running_callbacks--;
+    if (object_is_finished( wait, TRUE ))
+        RtlWakeAllConditionVariable( &wait->group_finished_event );
+    wait->num_associated_callbacks--;
+    if (object_is_finished( wait, FALSE ))
+        RtlWakeAllConditionVariable( &wait->finished_event );
+    RtlLeaveCriticalSection( &pool->cs );
+
+    tp_object_release( wait );
+}
+
 /***********************************************************************
  *           waitqueue_thread_proc    (internal)
  */
 static void CALLBACK waitqueue_thread_proc( void *param )
 {
     struct threadpool_object *objects[MAXIMUM_WAITQUEUE_OBJECTS];
+    struct threadpool_object *expired[MAXIMUM_WAITQUEUE_OBJECTS];
     HANDLE handles[MAXIMUM_WAITQUEUE_OBJECTS + 1];
     struct waitqueue_bucket *bucket = param;
     struct threadpool_object *wait, *next;
     LARGE_INTEGER now, timeout;
-    DWORD num_handles;
+    DWORD num_handles, num_expired;
+    TP_WAIT_RESULT result;
     NTSTATUS status;
 
     TRACE( "starting wait queue thread\n" );
@@ -1473,6 +1468,7 @@ static void CALLBACK waitqueue_thread_proc( void *param )
         NtQuerySystemTime( &now );
         timeout.QuadPart = TIMEOUT_INFINITE;
         num_handles = 0;
+        num_expired = 0;
 
         LIST_FOR_EACH_ENTRY_SAFE( wait, next, &bucket->waiting, struct threadpool_object,
                                   u.wait.wait_entry )
@@ -1483,7 +1479,13 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                 /* Wait object timed out. */
                 list_remove( &wait->u.wait.wait_entry );
                 list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
-                tp_object_submit( wait, FALSE );
+                if (wait->u.wait.flags & (WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD))
+                {
+                    InterlockedIncrement( &wait->refcount );
+                    expired[num_expired++] = wait;
+                }
+                else
+                    tp_object_submit( wait, FALSE );
             }
             else
             {
@@ -1498,6 +1500,29 @@ static void CALLBACK waitqueue_thread_proc( void *param )
             }
         }
 
+        if (num_expired)
+        {
+            /* Callbacks executed in this thread release the lock, so the
+             * waiting list has to be scanned again afterwards. */
+            while (num_handles)
+                tp_object_release( objects[--num_handles] );
+            while (num_expired)
+            {
+                wait = expired[--num_expired];
+                result = WAIT_TIMEOUT;
+                /* zero timeout waits still report an already signaled object */
+                if (!wait->u.wait.timeout && wait->u.wait.handle)
+                {
+                    timeout.QuadPart = 0;
+                    if (NtWaitForSingleObject( wait->u.wait.handle, FALSE, &timeout ) == STATUS_WAIT_0)
+                        result = WAIT_OBJECT_0;
+                }
+                waitqueue_execute_callback( wait, result );
+                tp_object_release( wait );
+            }
+            continue;
+        }
+
         if (!bucket->objcount)
         {
             /* All wait objects have been destroyed, if no new wait objects are created
@@ -1515,7 +1540,7 @@ static void CALLBACK waitqueue_thread_proc( void *param )
         {
             handles[num_handles] = bucket->update_event;
             RtlLeaveCriticalSection( &waitqueue.cs );
-            status = NtWaitForMultipleObjects( num_handles + 1, handles, TRUE, FALSE, &timeout );
+            status = NtWaitForMultipleObjects( num_handles + 1, handles, TRUE, bucket->alertable, &timeout );
             RtlEnterCriticalSection( &waitqueue.cs );
 
             if (status >= STATUS_WAIT_0 && status < STATUS_WAIT_0 + num_handles)
@@ -1528,7 +1553,10 @@ static void CALLBACK waitqueue_thread_proc( void *param )
                     assert( wait->u.wait.bucket == bucket );
                     list_remove( &wait->u.wait.wait_entry );
                     list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
-                    tp_object_submit( wait, TRUE );
+                    if (wait->u.wait.flags & (WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD))
+                        waitqueue_execute_callback( wait, WAIT_OBJECT_0 );
+                    else
+                        tp_object_submit( wait, TRUE );
                 }
                 else
                     WARN("wait object %p triggered while object was destroyed\n", wait);
@@ -1551,6 +1579,7 @@ static void CALLBACK waitqueue_thread_proc( void *param )
             LIST_FOR_EACH_ENTRY( other_bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
             {
                 if (other_bucket != bucket && other_bucket->objcount &&
+                    other_bucket->alertable == bucket->alertable &&
                     other_bucket->objcount + bucket->objcount <= MAXIMUM_WAITQUEUE_OBJECTS * 2 / 3)
                 {
                     other_bucket->objcount += bucket->objcount;
@@ -1610,6 +1639,7 @@ static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
     struct waitqueue_bucket *bucket;
     NTSTATUS status;
     HANDLE thread;
+    BOOL alertable = (wait->u.wait.flags & WT_EXECUTEINIOTHREAD) != 0;
     assert( wait->type == TP_OBJECT_TYPE_WAIT );
 
     wait->u.wait.signaled       = 0;
@@ -1623,7 +1653,7 @@ static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
     /* Try to assign to existing bucket if possible. */
     LIST_FOR_EACH_ENTRY( bucket, &waitqueue.buckets, struct waitqueue_bucket, bucket_entry )
     {
-        if (bucket->objcount < MAXIMUM_WAITQUEUE_OBJECTS)
+        if (bucket->objcount < MAXIMUM_WAITQUEUE_OBJECTS && bucket->alertable == alertable)
         {
             list_add_tail( &bucket->reserved, &wait->u.wait.wait_entry );
             wait->u.wait.bucket = bucket;
@@ -1643,6 +1673,7 @@ static NTSTATUS tp_waitqueue_lock( struct threadpool_object *wait )
     }
 
     bucket->objcount = 0;
+    bucket->alertable = alertable;
     list_init( &bucket->reserved );
     list_init( &bucket->waiting );
 
@@ -2078,6 +2109,7 @@ static void tp_object_initialize( struct threadpool_object *object, struct threa
     object->num_pending_callbacks   = 0;
     object->num_running_callbacks   = 0;
     object->num_associated_callbacks = 0;
+    object->completed_event         = NULL;
 
     if (environment)
     {
@@ -2292,6 +2324,9 @@ static BOOL tp_object_release( struct threadpool_object *object )
     if (object->race_dll)
         LdrUnloadDll( object->race_dll );
 
+    if (object->completed_event && object->completed_event != INVALID_HANDLE_VALUE)
+        NtSetEvent( object->completed_event, NULL );
+
     RtlFreeHeap( GetProcessHeap(), 0, object );
     return TRUE;
 }
@@ -2617,18 +2652,13 @@ NTSTATUS WINAPI TpAllocTimer( TP_TIMER **out, PTP_TIMER_CALLBACK callback, PVOID
     return STATUS_SUCCESS;
 }
 
-/***********************************************************************
- *           TpAllocWait     (NTDLL.@)
- */
-NTSTATUS WINAPI TpAllocWait( TP_WAIT **out, PTP_WAIT_CALLBACK callback, PVOID userdata,
-                             TP_CALLBACK_ENVIRON *environment )
+static NTSTATUS tp_alloc_wait( TP_WAIT **out, PTP_WAIT_CALLBACK callback, PVOID userdata,
+                               TP_CALLBACK_ENVIRON *environment, DWORD flags )
 {
     struct threadpool_object *object;
     struct threadpool *pool;
     NTSTATUS status;
 
-    TRACE( "%p %p %p %p\n", out, callback, userdata, environment );
-
     object = RtlAllocateHeap( GetProcessHeap(), 0, sizeof(*object) );
     if (!object)
         return STATUS_NO_MEMORY;
@@ -2642,6 +2672,7 @@ NTSTATUS WINAPI TpAllocWait( TP_WAIT **out, PTP_WAIT_CALLBACK callback, PVOID us
 
     object->type = TP_OBJECT_TYPE_WAIT;
     object->u.wait.callback = callback;
+    object->u.wait.flags = flags;
 
     status = tp_waitqueue_lock( object );
     if (status)
@@ -2657,6 +2688,17 @@ NTSTATUS WINAPI TpAllocWait( TP_WAIT **out, PTP_WAIT_CALLBACK callback, PVOID us
     return STATUS_SUCCESS;
 }
 
+/***********************************************************************
+ *           TpAllocWait     (NTDLL.@)
+ */
+NTSTATUS WINAPI TpAllocWait( TP_WAIT **out, PTP_WAIT_CALLBACK callback, PVOID userdata,
+                             TP_CALLBACK_ENVIRON *environment )
+{
+    TRACE( "%p %p %p %p\n", out, callback, userdata, environment );
+
+    return tp_alloc_wait( out, callback, userdata, environment, WT_EXECUTEONLYONCE );
+}
+
 /***********************************************************************
  *           TpAllocWork    (NTDLL.@)
  */
@@ -3181,7 +3223,7 @@ VOID WINAPI TpSetWait( TP_WAIT *wait, HANDLE handle, LARGE_INTEGER *timeout )
                 NtQuerySystemTime( &now );
                 timestamp = now.QuadPart - timestamp;
             }
-            else if (!timestamp)
+            else if (!timestamp && !(this->u.wait.flags & (WT_EXECUTEINWAITTHREAD | WT_EXECUTEINIOTHREAD)))
             {
                 submit_wait = TRUE;
                 handle = NULL;
@@ -2283,6 +2283,12 @@ static NTSTATUS virtual_map_section( HANDLE handle, PVOID *addr_ptr, unsigned sh
 
         res = map_image_into_view( view, unix_handle, base, image_info->header_size,
                                    image_info->image_flags, shared_fd, needs_close );
+#ifdef MADV_MERGEABLE
+        /* Pages modified by relocations become private copies, but they are identical in
+         * all the processes that map the image at the same address, so let the kernel
+         * merge them again if same-page merging is enabled. */
+        if (!res && view->base != base) madvise( view->base, view->size, MADV_MERGEABLE );
+#endif
     }
     else
     {
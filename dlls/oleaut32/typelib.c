@@ -7225,6 +7225,8 @@ static inline BOOL func_restricted( const FUNCDESC *desc )
     ((VARIANTARG **)((char *)(buffer) + (sizeof(VARIANTARG) + sizeof(VARIANTARG)) * (params)))
 #define INVBUF_GET_ARG_TYPE_ARRAY(buffer, params) \
     ((VARTYPE *)((char *)(buffer) + (sizeof(VARIANTARG) + sizeof(VARIANTARG) + sizeof(VARIANTARG *)) * (params)))
+/* functions with at most this many parameters get their buffer on the stack */
+#define INVBUF_STACK_PARAMS 8
 
 static HRESULT WINAPI ITypeInfo_fnInvoke(
     ITypeInfo2 *iface,
@@ -7288,7 +7290,10 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
 	switch (func_desc->funckind) {
 	case FUNC_PUREVIRTUAL:
 	case FUNC_VIRTUAL: {
-            void *buffer = heap_alloc_zero(INVBUF_ELEMENT_SIZE * func_desc->cParams);
+            VARIANTARG stack_buffer[(INVBUF_ELEMENT_SIZE * INVBUF_STACK_PARAMS + sizeof(VARIANTARG) - 1) / sizeof(VARIANTARG)];
+            void *buffer = func_desc->cParams <= INVBUF_STACK_PARAMS ?
+                    memset(stack_buffer, 0, INVBUF_ELEMENT_SIZE * func_desc->cParams) :
+                    heap_alloc_zero(INVBUF_ELEMENT_SIZE * func_desc->cParams);
             VARIANT varresult;
             VARIANT retval; /* pointer for storing byref retvals in */
             VARIANTARG **prgpvarg = INVBUF_GET_ARG_PTR_ARRAY(buffer, func_desc->cParams);
@@ -7697,7 +7702,7 @@ static HRESULT WINAPI ITypeInfo_fnInvoke(
             }
 
 func_fail:
-            heap_free(buffer);
+            if (buffer != stack_buffer) heap_free(buffer);
             break;
         }
 	case FUNC_DISPATCH:  {
@@ -290,6 +290,15 @@ static size_t get_handle_desc_size(const NDR_PROC_HEADER *proc_header, PFORMAT_S
     return 0;
 }
 
+/* widl describes an explicit primitive handle as a plain [in] parameter that
+ * isn't counted in the constant buffer sizes, so such procedures must size
+ * every parameter */
+static BOOL has_explicit_primitive_handle(const NDR_PROC_HEADER *proc_header, PFORMAT_STRING format)
+{
+    return !(proc_header->Oi_flags & Oi_OBJECT_PROC) && !proc_header->handle_type &&
+           *format == FC_BIND_PRIMITIVE;
+}
+
 static handle_t client_get_handle(const MIDL_STUB_MESSAGE *pStubMsg,
         const NDR_PROC_HEADER *pProcHeader, const PFORMAT_STRING pFormat)
 {
@@ -541,6 +550,27 @@ void client_do_args( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat, enum s
     }
 }
 
+/* size the [in] parameters on the client side using the constant buffer size
+ * from the procedure header, only walking the ones that need explicit sizing */
+static void client_size_args( PMIDL_STUB_MESSAGE pStubMsg, PFORMAT_STRING pFormat,
+                              unsigned short number_of_params, unsigned short constant_size )
+{
+    const NDR_PARAM_OIF *params = (const NDR_PARAM_OIF *)pFormat;
+    unsigned int i;
+
+    pStubMsg->BufferLength = constant_size;
+
+    for (i = 0; i < number_of_params; i++)
+    {
+        unsigned char *pArg = pStubMsg->StackTop + params[i].stack_offset;
+
+        if (params[i].attr.IsSimpleRef && !*(unsigned char **)pArg)
+            RpcRaiseException(RPC_X_NULL_REF_POINTER);
+        if (params[i].attr.IsIn && params[i].attr.MustSize)
+            call_buffer_sizer(pStubMsg, pArg, &params[i]);
+    }
+}
+
 static unsigned int type_stack_size(unsigned char fc)
 {
     switch (fc)
@@ -705,7 +735,8 @@ static void CALLBACK ndr_client_call_finally(BOOL normal, void *arg)
 static LONG_PTR do_ndr_client_call( const MIDL_STUB_DESC *stub_desc, const PFORMAT_STRING format,
         const PFORMAT_STRING handle_format, void **stack_top, void **fpu_stack, MIDL_STUB_MESSAGE *stub_msg,
         unsigned short procedure_number, unsigned short stack_size, unsigned int number_of_params,
-        INTERPRETER_OPT_FLAGS Oif_flags, INTERPRETER_OPT_FLAGS2 ext_flags, const NDR_PROC_HEADER *proc_header )
+        INTERPRETER_OPT_FLAGS Oif_flags, INTERPRETER_OPT_FLAGS2 ext_flags, const NDR_PROC_HEADER *proc_header,
+        const NDR_PROC_PARTIAL_OIF_HEADER *oif_header )
 {
     struct ndr_client_call_ctx finally_ctx;
     RPC_MESSAGE rpc_msg;
@@ -795,8 +826,11 @@ static LONG_PTR do_ndr_client_call( const MIDL_STUB_DESC *stub_desc, const PFORM
 
         /* 2. CALCSIZE */
         TRACE( "CALCSIZE\n" );
-        client_do_args(stub_msg, format, STUBLESS_CALCSIZE, fpu_stack,
-                       number_of_params, (unsigned char *)&retval);
+        if (oif_header && !has_explicit_primitive_handle(proc_header, handle_format))
+            client_size_args(stub_msg, format, number_of_params, oif_header->constant_client_buffer_size);
+        else
+            client_do_args(stub_msg, format, STUBLESS_CALCSIZE, fpu_stack,
+                           number_of_params, (unsigned char *)&retval);
 
         /* 3. GETBUFFER */
         TRACE( "GETBUFFER\n" );
@@ -866,6 +900,8 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
     INTERPRETER_OPT_FLAGS2 ext_flags = { 0 };
     /* header for procedure string */
     const NDR_PROC_HEADER * pProcHeader = (const NDR_PROC_HEADER *)&pFormat[0];
+    /* -Oicf header, NULL for the old format */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
     /* the value to return to the client from the remote procedure */
     LONG_PTR RetVal = 0;
     PFORMAT_STRING pHandleFormat;
@@ -901,9 +937,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
 
     if (is_oicf_stubdesc(pStubDesc))  /* -Oicf format */
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader =
-            (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
-
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
         Oif_flags = pOIFHeader->Oi2Flags;
         number_of_params = pOIFHeader->number_of_params;
 
@@ -944,7 +978,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
         {
             RetVal = do_ndr_client_call(pStubDesc, pFormat, pHandleFormat,
                     stack_top, fpu_stack, &stubMsg, procedure_number, stack_size,
-                    number_of_params, Oif_flags, ext_flags, pProcHeader);
+                    number_of_params, Oif_flags, ext_flags, pProcHeader, pOIFHeader);
         }
         __EXCEPT_ALL
         {
@@ -962,7 +996,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
         {
             RetVal = do_ndr_client_call(pStubDesc, pFormat, pHandleFormat,
                     stack_top, fpu_stack, &stubMsg, procedure_number, stack_size,
-                    number_of_params, Oif_flags, ext_flags, pProcHeader);
+                    number_of_params, Oif_flags, ext_flags, pProcHeader, pOIFHeader);
         }
         __EXCEPT_ALL
         {
@@ -995,7 +1029,7 @@ LONG_PTR CDECL DECLSPEC_HIDDEN ndr_client_call( PMIDL_STUB_DESC pStubDesc, PFORM
     {
         RetVal = do_ndr_client_call(pStubDesc, pFormat, pHandleFormat,
                 stack_top, fpu_stack, &stubMsg, procedure_number, stack_size,
-                number_of_params, Oif_flags, ext_flags, pProcHeader);
+                number_of_params, Oif_flags, ext_flags, pProcHeader, pOIFHeader);
     }
 
     TRACE("RetVal = 0x%lx\n", RetVal);
@@ -1295,6 +1329,23 @@ static LONG_PTR *stub_do_args(MIDL_STUB_MESSAGE *pStubMsg,
     return retval_ptr;
 }
 
+/* size the [out] parameters on the server side using the constant buffer size
+ * from the procedure header, only walking the ones that need explicit sizing */
+static void stub_size_args( MIDL_STUB_MESSAGE *pStubMsg, PFORMAT_STRING pFormat,
+                            unsigned short number_of_params, unsigned short constant_size )
+{
+    const NDR_PARAM_OIF *params = (const NDR_PARAM_OIF *)pFormat;
+    unsigned int i;
+
+    pStubMsg->BufferLength = constant_size;
+
+    for (i = 0; i < number_of_params; i++)
+    {
+        if ((params[i].attr.IsOut || params[i].attr.IsReturn) && params[i].attr.MustSize)
+            call_buffer_sizer(pStubMsg, pStubMsg->StackTop + params[i].stack_offset, &params[i]);
+    }
+}
+
 /***********************************************************************
  *            NdrStubCall2 [RPCRT4.@]
  *
@@ -1328,6 +1379,9 @@ LONG WINAPI NdrStubCall2(
     enum stubless_phase phase;
     /* header for procedure string */
     const NDR_PROC_HEADER *pProcHeader;
+    /* -Oicf header, NULL for the old format */
+    const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = NULL;
+    PFORMAT_STRING pHandleFormat;
     /* location to put retval into */
     LONG_PTR *retval_ptr = NULL;
     /* correlation cache */
@@ -1361,6 +1415,8 @@ LONG WINAPI NdrStubCall2(
 
     TRACE("Oi_flags = 0x%02x\n", pProcHeader->Oi_flags);
 
+    pHandleFormat = pFormat;
+
     /* binding */
     switch (pProcHeader->handle_type)
     {
@@ -1425,8 +1481,7 @@ LONG WINAPI NdrStubCall2(
 
     if (is_oicf_stubdesc(pStubDesc))
     {
-        const NDR_PROC_PARTIAL_OIF_HEADER *pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
-
+        pOIFHeader = (const NDR_PROC_PARTIAL_OIF_HEADER *)pFormat;
         Oif_flags = pOIFHeader->Oi2Flags;
         number_of_params = pOIFHeader->number_of_params;
 
@@ -1522,9 +1577,15 @@ LONG WINAPI NdrStubCall2(
                 stubMsg.Buffer = pRpcMsg->Buffer;
             }
             break;
+        case STUBLESS_CALCSIZE:
+            if (pOIFHeader && !has_explicit_primitive_handle(pProcHeader, pHandleFormat))
+            {
+                stub_size_args(&stubMsg, pFormat, number_of_params, pOIFHeader->constant_server_buffer_size);
+                break;
+            }
+            /* fall through */
         case STUBLESS_UNMARSHAL:
         case STUBLESS_INITOUT:
-        case STUBLESS_CALCSIZE:
         case STUBLESS_MARSHAL:
         case STUBLESS_MUSTFREE:
         case STUBLESS_FREE:
@@ -468,6 +468,84 @@ static int rpcrt4_conn_np_wait_for_incoming_data(RpcConnection *conn)
     return rpcrt4_conn_np_read(conn, NULL, 0);
 }
 
+/* The pipes are in message mode and each fragment is written as a single
+ * message, so read the whole fragment at once instead of reading the common
+ * header, the rest of the header and the payload separately. */
+static RPC_STATUS rpcrt4_conn_np_receive_fragment(RpcConnection *conn, RpcPktHdr **Header, void **Payload)
+{
+    RpcPktCommonHdr *common_hdr;
+    char buffer[RPC_MAX_PACKET_SIZE];
+    DWORD hdr_length, data_length;
+    RPC_STATUS status;
+    LONG count;
+
+    *Header = NULL;
+    *Payload = NULL;
+
+    TRACE("(%p, %p, %p)\n", conn, Header, Payload);
+
+    count = rpcrt4_conn_np_read(conn, buffer, sizeof(buffer));
+    if (count < (LONG)sizeof(*common_hdr))
+    {
+        WARN("Short read of header, %d bytes\n", count);
+        return RPC_S_CALL_FAILED;
+    }
+    common_hdr = (RpcPktCommonHdr *)buffer;
+
+    status = RPCRT4_ValidateCommonHeader(common_hdr);
+    if (status != RPC_S_OK) return status;
+
+    hdr_length = RPCRT4_GetHeaderSize((RpcPktHdr *)common_hdr);
+    if (hdr_length == 0)
+    {
+        WARN("header length == 0\n");
+        return RPC_S_PROTOCOL_ERROR;
+    }
+    if (count < hdr_length || count > common_hdr->frag_len)
+    {
+        WARN("bad fragment length, %d bytes, hdr_length %d, frag_len %d\n",
+             count, hdr_length, common_hdr->frag_len);
+        return RPC_S_CALL_FAILED;
+    }
+
+    if (!(*Header = HeapAlloc(GetProcessHeap(), 0, hdr_length)))
+        return RPC_S_OUT_OF_RESOURCES;
+    memcpy(*Header, buffer, hdr_length);
+
+    data_length = common_hdr->frag_len - hdr_length;
+    if (data_length)
+    {
+        if (!(*Payload = HeapAlloc(GetProcessHeap(), 0, data_length)))
+        {
+            status = RPC_S_OUT_OF_RESOURCES;
+            goto fail;
+        }
+        memcpy(*Payload, buffer + hdr_length, count - hdr_length);
+
+        /* fragments larger than the buffer are completed with the rest of the message */
+        if (count < common_hdr->frag_len)
+        {
+            LONG remaining = common_hdr->frag_len - count;
+
+            if (rpcrt4_conn_np_read(conn, (char *)*Payload + count - hdr_length, remaining) != remaining)
+            {
+                WARN("bad data length, frag_len %d\n", common_hdr->frag_len);
+                status = RPC_S_CALL_FAILED;
+                goto fail;
+            }
+        }
+    }
+
+    return RPC_S_OK;
+
+fail:
+    RPCRT4_FreeHeader(*Header);
+    *Header = NULL;
+    HeapFree(GetProcessHeap(), 0, *Payload);
+    *Payload = NULL;
+    return status;
+}
+
 static size_t rpcrt4_ncacn_np_get_top_of_tower(unsigned char *tower_data,
                                                const char *networkaddr,
                                                const char *endpoint)
@@ -3145,7 +3223,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncacn_np_get_top_of_tower,
     rpcrt4_ncacn_np_parse_top_of_tower,
-    NULL,
+    rpcrt4_conn_np_receive_fragment,
     RPCRT4_default_is_authorized,
     RPCRT4_default_authorize,
     RPCRT4_default_secure_packet,
@@ -3167,7 +3245,7 @@ static const struct connection_ops conn_protseq_list[] = {
     rpcrt4_conn_np_wait_for_incoming_data,
     rpcrt4_ncalrpc_get_top_of_tower,
     rpcrt4_ncalrpc_parse_top_of_tower,
-    NULL,
+    rpcrt4_conn_np_receive_fragment,
     rpcrt4_ncalrpc_is_authorized,
     rpcrt4_ncalrpc_authorize,
     rpcrt4_ncalrpc_secure_packet,
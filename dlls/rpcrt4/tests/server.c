@@ -147,6 +147,7 @@ static int (__cdecl *sum_array_ptr)(int (*a)[2]);
 static ctx_handle_t (__cdecl *get_handle)(void);
 static void (__cdecl *get_handle_by_ptr)(ctx_handle_t *r);
 static void (__cdecl *test_handle)(ctx_handle_t ctx_handle);
+static int (__cdecl *square_explicit_handle)(handle_t binding, int x);
 
 #define SERVER_FUNCTIONS \
     X(int_return) \
@@ -240,7 +241,8 @@ static void (__cdecl *test_handle)(ctx_handle_t ctx_handle);
     X(sum_array_ptr) \
     X(get_handle) \
     X(get_handle_by_ptr) \
-    X(test_handle)
+    X(test_handle) \
+    X(square_explicit_handle)
 
 /* type check statements generated in header file */
 fnprintf *p_printf = printf;
@@ -1125,6 +1127,12 @@ void __cdecl s_test_handle(ctx_handle_t ctx_handle)
     ok(ctx_handle == (ctx_handle_t)0xdeadbeef, "Unexpected ctx_handle %p\n", ctx_handle);
 }
 
+int __cdecl s_square_explicit_handle(handle_t binding, int x)
+{
+    ok(binding != NULL, "got NULL binding\n");
+    return x * x;
+}
+
 void __RPC_USER ctx_handle_t_rundown(ctx_handle_t ctx_handle)
 {
     ok(ctx_handle == (ctx_handle_t)0xdeadbeef, "Unexpected ctx_handle %p\n", ctx_handle);
@@ -1187,6 +1195,8 @@ basic_tests(void)
   ok(int_return() == INT_CODE, "RPC int_return\n");
 
   ok(square(7) == 49, "RPC square\n");
+  x = square_explicit_handle(is_interp ? IInterpServer_IfHandle : IMixedServer_IfHandle, 9);
+  ok(x == 81, "RPC square_explicit_handle got %d\n", x);
   x = sum(23, -4);
   ok(x == 19, "RPC sum got %d\n", x);
   c = sum_char(-23, 50);
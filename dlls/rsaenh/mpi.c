@@ -3093,6 +3093,9 @@ mp_montgomery_setup (const mp_int * n, mp_digit * rho)
   x *= 2 - b * x;               /* here x*a==1 mod 2**8 */
   x *= 2 - b * x;               /* here x*a==1 mod 2**16 */
   x *= 2 - b * x;               /* here x*a==1 mod 2**32 */
+#ifdef MP_64BIT
+  x *= 2 - b * x;               /* here x*a==1 mod 2**64 */
+#endif
 
   /* rho = -1/m mod b */
   *rho = (((mp_word)1 << ((mp_word) DIGIT_BIT)) - x) & MP_MASK;
@@ -172,9 +172,17 @@ unsigned long rc4_read(unsigned char *buf, unsigned long len, prng_state *prng);
  * At the very least a mp_digit must be able to hold 7 bits
  * [any size beyond that is ok provided it doesn't overflow the data type]
  */
+#if defined(__GNUC__) && defined(__SIZEOF_INT128__)
+/* 60-bit digits need roughly a quarter of the digit operations of 28-bit ones */
+#define MP_64BIT
+typedef ulong64            mp_digit;
+typedef unsigned __int128  mp_word;
+#define DIGIT_BIT 60
+#else
 typedef unsigned long      mp_digit;
 typedef ulong64            mp_word;
 #define DIGIT_BIT 28
+#endif
    
 #define MP_DIGIT_BIT     DIGIT_BIT
 #define MP_MASK          ((((mp_digit)1)<<((mp_digit)DIGIT_BIT))-((mp_digit)1))
@@ -205,6 +205,142 @@ static void NearestNeighbor_CopyScanline(BitmapScaler *This,
     }
 }
 
+/* Formats in which every byte is an independent channel, so that pixels
+ * can be blended byte by byte. */
+static BOOL is_blendable_format(const WICPixelFormatGUID *format)
+{
+    static const WICPixelFormatGUID *formats[] =
+    {
+        &GUID_WICPixelFormat8bppGray,
+        &GUID_WICPixelFormat8bppAlpha,
+        &GUID_WICPixelFormat24bppBGR,
+        &GUID_WICPixelFormat24bppRGB,
+        &GUID_WICPixelFormat32bppBGR,
+        &GUID_WICPixelFormat32bppBGRA,
+        &GUID_WICPixelFormat32bppPBGRA,
+        &GUID_WICPixelFormat32bppRGB,
+        &GUID_WICPixelFormat32bppRGBA,
+        &GUID_WICPixelFormat32bppPRGBA,
+    };
+    UINT i;
+
+    for (i = 0; i < ARRAY_SIZE(formats); i++)
+        if (IsEqualGUID(format, formats[i])) return TRUE;
+    return FALSE;
+}
+
+/* Fant: each destination pixel is the average of the source pixels it covers,
+ * or the nearest source pixel when upscaling. */
+static void Fant_GetSourceSpan(UINT dst, UINT dst_size, UINT src_size, UINT *start, UINT *end)
+{
+    *start = (UINT64)dst * src_size / dst_size;
+    *end = (UINT64)(dst + 1) * src_size / dst_size;
+    if (*end <= *start) *end = *start + 1;
+}
+
+static void Fant_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    UINT start, end;
+
+    Fant_GetSourceSpan(x, This->width, This->src_width, &start, &end);
+    src_rect->X = start;
+    src_rect->Width = end - start;
+    Fant_GetSourceSpan(y, This->height, This->src_height, &start, &end);
+    src_rect->Y = start;
+    src_rect->Height = end - start;
+}
+
+static void Fant_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    UINT bytesperpixel = This->bpp/8;
+    UINT i, c, x, y, x0, x1, y0, y1;
+    UINT64 sums[4], count;
+
+    Fant_GetSourceSpan(dst_y, This->height, This->src_height, &y0, &y1);
+    y0 -= src_data_y;
+    y1 -= src_data_y;
+
+    for (i=0; i<dst_width; i++)
+    {
+        Fant_GetSourceSpan(dst_x + i, This->width, This->src_width, &x0, &x1);
+        x0 -= src_data_x;
+        x1 -= src_data_x;
+        count = (x1 - x0) * (y1 - y0);
+
+        memset(sums, 0, sizeof(sums));
+        for (y = y0; y < y1; y++)
+        {
+            const BYTE *src = src_data[y] + bytesperpixel * x0;
+            for (x = x0; x < x1; x++, src += bytesperpixel)
+                for (c = 0; c < bytesperpixel; c++)
+                    sums[c] += src[c];
+        }
+        for (c = 0; c < bytesperpixel; c++)
+            pbBuffer[bytesperpixel * i + c] = (sums[c] + count / 2) / count;
+    }
+}
+
+/* Linear: blend the 2x2 source pixels around the destination pixel center,
+ * with 8-bit fixed point weights. */
+static void Linear_GetSourcePos(UINT dst, UINT dst_size, UINT src_size, UINT *pos, UINT *weight)
+{
+    /* source coordinate of the pixel center, scaled by 256 */
+    INT64 center = ((INT64)(2 * dst + 1) * src_size * 256 / dst_size - 256) / 2;
+
+    if (center < 0) center = 0;
+    if (center > (INT64)(src_size - 1) * 256) center = (INT64)(src_size - 1) * 256;
+    *pos = center >> 8;
+    *weight = center & 0xff;
+}
+
+static void Linear_GetRequiredSourceRect(BitmapScaler *This,
+    UINT x, UINT y, WICRect *src_rect)
+{
+    UINT pos, weight;
+
+    Linear_GetSourcePos(x, This->width, This->src_width, &pos, &weight);
+    src_rect->X = pos;
+    src_rect->Width = pos + 1 < This->src_width ? 2 : 1;
+    Linear_GetSourcePos(y, This->height, This->src_height, &pos, &weight);
+    src_rect->Y = pos;
+    src_rect->Height = pos + 1 < This->src_height ? 2 : 1;
+}
+
+static void Linear_CopyScanline(BitmapScaler *This,
+    UINT dst_x, UINT dst_y, UINT dst_width,
+    BYTE **src_data, UINT src_data_x, UINT src_data_y, BYTE *pbBuffer)
+{
+    UINT bytesperpixel = This->bpp/8;
+    UINT i, c, src_x, src_y, wx, wy, dx;
+    const BYTE *row0, *row1;
+
+    Linear_GetSourcePos(dst_y, This->height, This->src_height, &src_y, &wy);
+    row0 = src_data[src_y - src_data_y];
+    row1 = wy ? src_data[src_y + 1 - src_data_y] : row0;
+
+    for (i=0; i<dst_width; i++)
+    {
+        const BYTE *p00, *p01, *p10, *p11;
+
+        Linear_GetSourcePos(dst_x + i, This->width, This->src_width, &src_x, &wx);
+        dx = wx ? bytesperpixel : 0;
+        p00 = row0 + bytesperpixel * (src_x - src_data_x);
+        p01 = p00 + dx;
+        p10 = row1 + bytesperpixel * (src_x - src_data_x);
+        p11 = p10 + dx;
+
+        for (c = 0; c < bytesperpixel; c++)
+        {
+            UINT top = p00[c] * (256 - wx) + p01[c] * wx;
+            UINT bottom = p10[c] * (256 - wx) + p11[c] * wx;
+            pbBuffer[bytesperpixel * i + c] = (top * (256 - wy) + bottom * wy + 0x8000) >> 16;
+        }
+    }
+}
+
 static HRESULT WINAPI BitmapScaler_CopyPixels(IWICBitmapScaler *iface,
     const WICRect *prc, UINT cbStride, UINT cbBufferSize, BYTE *pbBuffer)
 {
@@ -349,10 +485,33 @@ static HRESULT WINAPI BitmapScaler_Initialize(IWICBitmapScaler *iface,
         hr = get_pixelformat_bpp(&src_pixelformat, &This->bpp);
     }
 
+    if (SUCCEEDED(hr) && mode != WICBitmapInterpolationModeNearestNeighbor &&
+        !is_blendable_format(&src_pixelformat))
+    {
+        FIXME("mode %i not supported for format %s, using nearest neighbor\n",
+              mode, debugstr_guid(&src_pixelformat));
+        mode = WICBitmapInterpolationModeNearestNeighbor;
+    }
+
     if (SUCCEEDED(hr))
     {
         switch (mode)
         {
+        case WICBitmapInterpolationModeCubic:
+            FIXME("cubic interpolation not supported, using linear\n");
+            /* fall-through */
+        case WICBitmapInterpolationModeLinear:
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+            This->fn_get_required_source_rect = Linear_GetRequiredSourceRect;
+            This->fn_copy_scanline = Linear_CopyScanline;
+            break;
+        case WICBitmapInterpolationModeFant:
+            IWICBitmapSource_AddRef(pISource);
+            This->source = pISource;
+            This->fn_get_required_source_rect = Fant_GetRequiredSourceRect;
+            This->fn_copy_scanline = Fant_CopyScanline;
+            break;
         default:
             FIXME("unsupported mode %i\n", mode);
             /* fall-through */
@@ -19,6 +19,7 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 #include <math.h>
 
@@ -1312,6 +1313,146 @@ static void test_bitmap_scaler(void)
     IWICBitmap_Release(bitmap);
 }
 
+/* blended pixels may be rounded differently */
+static BOOL compare_blended(const BYTE *data, const BYTE *expected, UINT size)
+{
+    UINT i;
+
+    for (i = 0; i < size; i++)
+        if (abs(data[i] - expected[i]) > 1) return FALSE;
+    return TRUE;
+}
+
+static IWICBitmapScaler *create_scaler(const WICPixelFormatGUID *format, UINT width, UINT height,
+    UINT stride, const BYTE *data, UINT dst_width, UINT dst_height, WICBitmapInterpolationMode mode)
+{
+    IWICBitmapScaler *scaler;
+    IWICBitmap *bitmap;
+    HRESULT hr;
+
+    hr = IWICImagingFactory_CreateBitmapFromMemory(factory, width, height, format,
+        stride, stride * height, (BYTE *)data, &bitmap);
+    ok(hr == S_OK, "Failed to create a bitmap, hr %#x.\n", hr);
+
+    hr = IWICImagingFactory_CreateBitmapScaler(factory, &scaler);
+    ok(hr == S_OK, "Failed to create bitmap scaler, hr %#x.\n", hr);
+
+    hr = IWICBitmapScaler_Initialize(scaler, (IWICBitmapSource *)bitmap, dst_width, dst_height, mode);
+    ok(hr == S_OK, "Failed to initialize bitmap scaler, hr %#x.\n", hr);
+
+    IWICBitmap_Release(bitmap);
+    return scaler;
+}
+
+static void test_bitmap_scaler_fant(void)
+{
+    /* the alpha and the second pixel's color channels average to x.5 and x.75 */
+    static const BYTE src[] =
+    {
+        0x10,0x20,0x30,0xff, 0x30,0x40,0x50,0xff, 0x80,0x60,0x40,0x20, 0x81,0x61,0x41,0x20,
+        0x20,0x30,0x40,0x80, 0x40,0x50,0x60,0x80, 0x81,0x61,0x41,0x20, 0x81,0x61,0x41,0x20,
+    };
+    static const BYTE expected[] = { 0x28,0x38,0x48,0xc0, 0x81,0x61,0x41,0x20 };
+    static const BYTE src_gray[] = { 10, 20, 30, 40, 50, 60, 70, 80, 90, 100 };
+    static const BYTE expected_gray[] = { 20, 50, 85 };
+    static const float src_float[] = { 0.0f, 0.25f, 0.5f, 1.0f };
+    const WICRect rect = { 1, 0, 1, 1 };
+    IWICBitmapScaler *scaler;
+    float buf_float[2];
+    BYTE buf[8];
+    HRESULT hr;
+
+    scaler = create_scaler(&GUID_WICPixelFormat32bppBGRA, 4, 2, 16, src, 2, 1,
+        WICBitmapInterpolationModeFant);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 8, sizeof(buf), buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(compare_blended(buf, expected, sizeof(expected)), "Unexpected data %02x %02x %02x %02x %02x %02x %02x %02x.\n",
+        buf[0], buf[1], buf[2], buf[3], buf[4], buf[5], buf[6], buf[7]);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, &rect, 4, 4, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(compare_blended(buf, expected + 4, 4), "Unexpected data %02x %02x %02x %02x.\n",
+        buf[0], buf[1], buf[2], buf[3]);
+
+    IWICBitmapScaler_Release(scaler);
+
+    /* source boxes of unequal width */
+    scaler = create_scaler(&GUID_WICPixelFormat8bppGray, 10, 1, 10, src_gray, 3, 1,
+        WICBitmapInterpolationModeFant);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 3, 3, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(compare_blended(buf, expected_gray, sizeof(expected_gray)), "Unexpected data %u %u %u.\n",
+        buf[0], buf[1], buf[2]);
+
+    IWICBitmapScaler_Release(scaler);
+
+    /* floating point formats */
+    scaler = create_scaler(&GUID_WICPixelFormat32bppGrayFloat, 4, 1, sizeof(src_float), (const BYTE *)src_float,
+        2, 1, WICBitmapInterpolationModeFant);
+
+    memset(buf_float, 0xcc, sizeof(buf_float));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, sizeof(buf_float), sizeof(buf_float), (BYTE *)buf_float);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    todo_wine
+    ok(buf_float[0] == 0.125f && buf_float[1] == 0.75f, "Unexpected data %f %f.\n", buf_float[0], buf_float[1]);
+
+    IWICBitmapScaler_Release(scaler);
+}
+
+static void test_bitmap_scaler_linear(void)
+{
+    static const BYTE src[] = { 0, 100, 200, 255 };
+    static const BYTE expected[] = { 0, 25, 75, 125, 175, 214, 241, 255 };
+    static const BYTE src_2d[] =
+    {
+        0,   90,
+        180, 30,
+    };
+    static const BYTE expected_2d[] =
+    {
+        0,   45,  90,
+        90,  75,  60,
+        180, 105, 30,
+    };
+    const WICRect rect = { 1, 1, 2, 2 };
+    IWICBitmapScaler *scaler;
+    BYTE buf[9];
+    HRESULT hr;
+
+    scaler = create_scaler(&GUID_WICPixelFormat8bppGray, 4, 1, 4, src, 8, 1,
+        WICBitmapInterpolationModeLinear);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 8, 8, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(compare_blended(buf, expected, sizeof(expected)), "Unexpected data %u %u %u %u %u %u %u %u.\n",
+        buf[0], buf[1], buf[2], buf[3], buf[4], buf[5], buf[6], buf[7]);
+
+    IWICBitmapScaler_Release(scaler);
+
+    scaler = create_scaler(&GUID_WICPixelFormat8bppGray, 2, 2, 2, src_2d, 3, 3,
+        WICBitmapInterpolationModeLinear);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, NULL, 3, 9, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(compare_blended(buf, expected_2d, sizeof(expected_2d)), "Unexpected data %u %u %u %u %u %u %u %u %u.\n",
+        buf[0], buf[1], buf[2], buf[3], buf[4], buf[5], buf[6], buf[7], buf[8]);
+
+    memset(buf, 0xcc, sizeof(buf));
+    hr = IWICBitmapScaler_CopyPixels(scaler, &rect, 2, 4, buf);
+    ok(hr == S_OK, "Failed to copy pixels, hr %#x.\n", hr);
+    ok(compare_blended(buf, expected_2d + 4, 2) && compare_blended(buf + 2, expected_2d + 7, 2),
+        "Unexpected data %u %u %u %u.\n", buf[0], buf[1], buf[2], buf[3]);
+
+    IWICBitmapScaler_Release(scaler);
+}
+
 static LONG obj_refcount(void *obj)
 {
     IUnknown_AddRef((IUnknown *)obj);
@@ -1482,6 +1623,8 @@ START_TEST(bitmap)
     test_CreateBitmapFromHBITMAP();
     test_clipper();
     test_bitmap_scaler();
+    test_bitmap_scaler_fant();
+    test_bitmap_scaler_linear();
 
     IWICImagingFactory_Release(factory);
 
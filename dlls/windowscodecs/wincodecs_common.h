@@ -168,6 +168,21 @@ void reverse_bgr8(UINT bytesperpixel, LPBYTE bits, UINT width, UINT height, INT
     {
         pixel = bits + stride * y;
 
+        if (bytesperpixel == 4)
+        {
+            /* swap bytes 0 and 2 of a whole pixel at once */
+            for (x=0; x<width; x++)
+            {
+                DWORD value;
+
+                memcpy(&value, pixel, sizeof(value));
+                value = (value & 0xff00ff00) | ((value & 0xff) << 16) | ((value >> 16) & 0xff);
+                memcpy(pixel, &value, sizeof(value));
+                pixel += 4;
+            }
+            continue;
+        }
+
         for (x=0; x<width; x++)
         {
             temp = pixel[2];
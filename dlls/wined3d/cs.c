@@ -21,6 +21,7 @@
 #include "wined3d_private.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(d3d);
+WINE_DECLARE_DEBUG_CHANNEL(d3d_perf);
 WINE_DECLARE_DEBUG_CHANNEL(fps);
 
 #define WINED3D_INITIAL_CS_SIZE 4096
@@ -614,6 +615,33 @@ static void wined3d_cs_exec_present(struct wined3d_cs *cs, const void *data)
     InterlockedDecrement(&cs->pending_presents);
 }
 
+static void wined3d_cs_report_stats(struct wined3d_cs *cs)
+{
+    struct wined3d_cs_stats *stats = &cs->stats;
+    DWORD time = GetTickCount();
+
+    /* every 1.5 seconds, like the fps channel */
+    if (time - stats->prev_time <= 1500)
+        return;
+
+    TRACE_(d3d_perf)("%p: %u frames, per frame %.1f draws, %.1f dispatches, %.1f blits, "
+            "%.1f uploads (%.1f KiB).\n",
+            cs, stats->frame_count, (float)stats->draw_count / stats->frame_count,
+            (float)stats->dispatch_count / stats->frame_count, (float)stats->blt_count / stats->frame_count,
+            (float)stats->upload_count / stats->frame_count, stats->upload_size / 1024.0f / stats->frame_count);
+    TRACE_(d3d_perf)("%p: per frame %.1f upload stalls, %.1f map stalls, %.1f synchronous op stalls, "
+            "%.1f explicit finish stalls, %.1f full queue waits, %.1f frame latency waits.\n",
+            cs, (float)stats->stall_count[WINED3D_CS_STALL_UPLOAD] / stats->frame_count,
+            (float)stats->stall_count[WINED3D_CS_STALL_MAP] / stats->frame_count,
+            (float)stats->stall_count[WINED3D_CS_STALL_SYNCHRONOUS] / stats->frame_count,
+            (float)stats->stall_count[WINED3D_CS_STALL_FINISH] / stats->frame_count,
+            (float)stats->queue_full_count / stats->frame_count,
+            (float)stats->latency_wait_count / stats->frame_count);
+
+    memset(stats, 0, sizeof(*stats));
+    stats->prev_time = time;
+}
+
 void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *swapchain,
         const RECT *src_rect, const RECT *dst_rect, HWND dst_window_override,
         unsigned int swap_interval, DWORD flags)
@@ -643,11 +671,17 @@ void wined3d_cs_emit_present(struct wined3d_cs *cs, struct wined3d_swapchain *sw
 
     /* Limit input latency by limiting the number of presents that we can get
      * ahead of the worker thread. */
+    if (pending >= swapchain->max_frame_latency)
+        ++cs->stats.latency_wait_count;
     while (pending >= swapchain->max_frame_latency)
     {
         wined3d_pause();
         pending = InterlockedCompareExchange(&cs->pending_presents, 0, 0);
     }
+
+    ++cs->stats.frame_count;
+    if (TRACE_ON(d3d_perf))
+        wined3d_cs_report_stats(cs);
 }
 
 static void wined3d_cs_exec_clear(struct wined3d_cs *cs, const void *data)
@@ -747,7 +781,7 @@ void wined3d_cs_emit_clear_rendertarget_view(struct wined3d_cs *cs, struct wined
 
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_DEFAULT);
     if (flags & WINED3DCLEAR_SYNCHRONOUS)
-        wined3d_cs_finish(cs, WINED3D_CS_QUEUE_DEFAULT);
+        cs->ops->finish(cs, WINED3D_CS_QUEUE_DEFAULT, WINED3D_CS_STALL_SYNCHRONOUS);
 }
 
 static void acquire_shader_resources(const struct wined3d_state *state, unsigned int shader_mask)
@@ -896,6 +930,7 @@ void wined3d_cs_emit_dispatch(struct wined3d_cs *cs,
 
     acquire_compute_pipeline_resources(state);
 
+    ++cs->stats.dispatch_count;
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
@@ -914,6 +949,7 @@ void wined3d_cs_emit_dispatch_indirect(struct wined3d_cs *cs,
     acquire_compute_pipeline_resources(state);
     wined3d_resource_acquire(&buffer->resource);
 
+    ++cs->stats.dispatch_count;
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
@@ -1060,6 +1096,7 @@ void wined3d_cs_emit_draw(struct wined3d_cs *cs, enum wined3d_primitive_type pri
 
     acquire_graphics_pipeline_resources(state, indexed, d3d_info);
 
+    ++cs->stats.draw_count;
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
@@ -1082,6 +1119,7 @@ void wined3d_cs_emit_draw_indirect(struct wined3d_cs *cs, enum wined3d_primitive
     acquire_graphics_pipeline_resources(state, indexed, d3d_info);
     wined3d_resource_acquire(&buffer->resource);
 
+    ++cs->stats.draw_count;
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_DEFAULT);
 }
 
@@ -2235,7 +2273,7 @@ HRESULT wined3d_cs_map(struct wined3d_cs *cs, struct wined3d_resource *resource,
     op->hr = &hr;
 
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_MAP);
-    wined3d_cs_finish(cs, WINED3D_CS_QUEUE_MAP);
+    cs->ops->finish(cs, WINED3D_CS_QUEUE_MAP, WINED3D_CS_STALL_MAP);
 
     return hr;
 }
@@ -2262,7 +2300,7 @@ HRESULT wined3d_cs_unmap(struct wined3d_cs *cs, struct wined3d_resource *resourc
     op->hr = &hr;
 
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_MAP);
-    wined3d_cs_finish(cs, WINED3D_CS_QUEUE_MAP);
+    cs->ops->finish(cs, WINED3D_CS_QUEUE_MAP, WINED3D_CS_STALL_MAP);
 
     return hr;
 }
@@ -2394,9 +2432,10 @@ void wined3d_cs_emit_blt_sub_resource(struct wined3d_cs *cs, struct wined3d_reso
     if (src_resource)
         wined3d_resource_acquire(src_resource);
 
+    ++cs->stats.blt_count;
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_DEFAULT);
     if (flags & WINED3D_BLT_SYNCHRONOUS)
-        wined3d_cs_finish(cs, WINED3D_CS_QUEUE_DEFAULT);
+        cs->ops->finish(cs, WINED3D_CS_QUEUE_DEFAULT, WINED3D_CS_STALL_SYNCHRONOUS);
 }
 
 static void wined3d_cs_exec_update_sub_resource(struct wined3d_cs *cs, const void *data)
@@ -2475,10 +2514,17 @@ void wined3d_cs_emit_update_sub_resource(struct wined3d_cs *cs, struct wined3d_r
 
     wined3d_resource_acquire(resource);
 
+    ++cs->stats.upload_count;
+    if (resource->type == WINED3D_RTYPE_BUFFER)
+        cs->stats.upload_size += box->right - box->left;
+    else
+        cs->stats.upload_size += wined3d_format_calculate_size(resource->format, 1,
+                box->right - box->left, box->bottom - box->top, box->back - box->front);
+
     wined3d_cs_submit(cs, WINED3D_CS_QUEUE_MAP);
     /* The data pointer may go away, so we need to wait until it is read.
      * Copying the data may be faster if it's small. */
-    wined3d_cs_finish(cs, WINED3D_CS_QUEUE_MAP);
+    cs->ops->finish(cs, WINED3D_CS_QUEUE_MAP, WINED3D_CS_STALL_UPLOAD);
 }
 
 static void wined3d_cs_exec_add_dirty_texture_region(struct wined3d_cs *cs, const void *data)
@@ -2706,7 +2752,8 @@ static void wined3d_cs_st_submit(struct wined3d_cs *cs, enum wined3d_cs_queue_id
         heap_free(data);
 }
 
-static void wined3d_cs_st_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id)
+static void wined3d_cs_st_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id,
+        enum wined3d_cs_stall_cause cause)
 {
 }
 
@@ -2750,6 +2797,7 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
     size_t queue_size = ARRAY_SIZE(queue->data);
     size_t header_size, packet_size, remaining;
     struct wined3d_cs_packet *packet;
+    BOOL waited = FALSE;
 
     header_size = FIELD_OFFSET(struct wined3d_cs_packet, data[0]);
     packet_size = FIELD_OFFSET(struct wined3d_cs_packet, data[size]);
@@ -2800,7 +2848,10 @@ static void *wined3d_cs_queue_require_space(struct wined3d_cs_queue *queue, size
 
         TRACE("Waiting for free space. Head %u, tail %u, packet size %lu.\n",
                 head, tail, (unsigned long)packet_size);
+        waited = TRUE;
     }
+    if (waited)
+        ++cs->stats.queue_full_count;
 
     packet = (struct wined3d_cs_packet *)&queue->data[queue->head];
     packet->size = size;
@@ -2815,11 +2866,14 @@ static void *wined3d_cs_mt_require_space(struct wined3d_cs *cs, size_t size, enu
     return wined3d_cs_queue_require_space(&cs->queue[queue_id], size, cs);
 }
 
-static void wined3d_cs_mt_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id)
+static void wined3d_cs_mt_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id,
+        enum wined3d_cs_stall_cause cause)
 {
     if (cs->thread_id == GetCurrentThreadId())
-        return wined3d_cs_st_finish(cs, queue_id);
+        return wined3d_cs_st_finish(cs, queue_id, cause);
 
+    if (cs->queue[queue_id].head != *(volatile LONG *)&cs->queue[queue_id].tail)
+        ++cs->stats.stall_count[cause];
     while (cs->queue[queue_id].head != *(volatile LONG *)&cs->queue[queue_id].tail)
         wined3d_pause();
 }
@@ -4602,11 +4602,37 @@ struct wined3d_cs_queue
     BYTE data[WINED3D_CS_QUEUE_SIZE];
 };
 
+/* What made the application thread wait for the CS thread to drain a queue. */
+enum wined3d_cs_stall_cause
+{
+    WINED3D_CS_STALL_FINISH,
+    WINED3D_CS_STALL_UPLOAD,
+    WINED3D_CS_STALL_MAP,
+    WINED3D_CS_STALL_SYNCHRONOUS,
+    WINED3D_CS_STALL_COUNT,
+};
+
+/* Counters collected on the application side of the command stream, and
+ * reported with the "d3d_perf" debug channel. */
+struct wined3d_cs_stats
+{
+    unsigned int frame_count;
+    unsigned int draw_count;
+    unsigned int dispatch_count;
+    unsigned int blt_count;
+    unsigned int upload_count;
+    SIZE_T upload_size;
+    unsigned int stall_count[WINED3D_CS_STALL_COUNT];
+    unsigned int queue_full_count;
+    unsigned int latency_wait_count;
+    DWORD prev_time;
+};
+
 struct wined3d_cs_ops
 {
     void *(*require_space)(struct wined3d_cs *cs, size_t size, enum wined3d_cs_queue_id queue_id);
     void (*submit)(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id);
-    void (*finish)(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id);
+    void (*finish)(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id, enum wined3d_cs_stall_cause cause);
     void (*push_constants)(struct wined3d_cs *cs, enum wined3d_push_constants p,
             unsigned int start_idx, unsigned int count, const void *constants);
 };
@@ -4629,6 +4655,8 @@ struct wined3d_cs
     HANDLE event;
     BOOL waiting_for_event;
     LONG pending_presents;
+
+    struct wined3d_cs_stats stats;
 };
 
 struct wined3d_cs *wined3d_cs_create(struct wined3d_device *device) DECLSPEC_HIDDEN;
@@ -4730,7 +4758,7 @@ HRESULT wined3d_cs_unmap(struct wined3d_cs *cs, struct wined3d_resource *resourc
 
 static inline void wined3d_cs_finish(struct wined3d_cs *cs, enum wined3d_cs_queue_id queue_id)
 {
-    cs->ops->finish(cs, queue_id);
+    cs->ops->finish(cs, queue_id, WINED3D_CS_STALL_FINISH);
 }
 
 static inline void wined3d_cs_push_constants(struct wined3d_cs *cs, enum wined3d_push_constants p,
@@ -277,15 +277,10 @@ void set_async_pending( struct async *async, int signal )
     }
 }
 
-/* create an async associated with iosb for async-based requests
- * returned async must be passed to async_handoff */
-struct async *create_request_async( struct fd *fd, unsigned int comp_flags, const async_data_t *data )
+static struct async *create_async_for_request( struct fd *fd, unsigned int comp_flags,
+                                               const async_data_t *data, struct iosb *iosb )
 {
     struct async *async;
-    struct iosb *iosb;
-
-    if (!(iosb = create_iosb( get_req_data(), get_req_data_size(), get_reply_max_size() )))
-        return NULL;
 
     async = create_async( fd, current, data, iosb );
     release_object( iosb );
@@ -303,6 +298,39 @@ struct async *create_request_async( struct fd *fd, unsigned int comp_flags, cons
     return async;
 }
 
+/* create an async associated with iosb for async-based requests
+ * returned async must be passed to async_handoff */
+struct async *create_request_async( struct fd *fd, unsigned int comp_flags, const async_data_t *data )
+{
+    struct iosb *iosb;
+
+    if (!(iosb = create_iosb( get_req_data(), get_req_data_size(), get_reply_max_size() )))
+        return NULL;
+
+    return create_async_for_request( fd, comp_flags, data, iosb );
+}
+
+/* same as create_request_async, but the iosb takes over the request data instead of copying it,
+ * so the request data is no longer available to the caller */
+struct async *create_request_async_move_data( struct fd *fd, unsigned int comp_flags,
+                                              const async_data_t *data )
+{
+    data_size_t size = get_req_data_size();
+    struct iosb *iosb;
+    void *ptr;
+
+    if (!size) return create_request_async( fd, comp_flags, data );
+
+    if (!(iosb = create_iosb( NULL, 0, get_reply_max_size() ))) return NULL;
+    /* the request buffer may be larger than the data, give back the unused part */
+    if (!(ptr = realloc( current->req_data, size ))) ptr = current->req_data;
+    current->req_data = NULL;
+    iosb->in_data = ptr;
+    iosb->in_size = size;
+
+    return create_async_for_request( fd, comp_flags, data, iosb );
+}
+
 /* return async object status and wait handle to client */
 obj_handle_t async_handoff( struct async *async, int success, data_size_t *result, int force_blocking )
 {
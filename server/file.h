@@ -209,6 +209,8 @@ extern struct object *create_serial( struct fd *fd );
 extern void free_async_queue( struct async_queue *queue );
 extern struct async *create_async( struct fd *fd, struct thread *thread, const async_data_t *data, struct iosb *iosb );
 extern struct async *create_request_async( struct fd *fd, unsigned int comp_flags, const async_data_t *data );
+extern struct async *create_request_async_move_data( struct fd *fd, unsigned int comp_flags,
+                                                     const async_data_t *data );
 extern obj_handle_t async_handoff( struct async *async, int success, data_size_t *result, int force_blocking );
 extern void queue_async( struct async_queue *queue, struct async *async );
 extern void async_set_timeout( struct async *async, timeout_t timeout, unsigned int status );
@@ -205,7 +205,10 @@ static void dump_path( const struct key *key, const struct key *base, FILE *f )
 /* dump a value to a text file */
 static void dump_value( const struct key_value *value, FILE *f )
 {
+    static const char hex[16] = "0123456789abcdef";
     unsigned int i, dw;
+    char buffer[256];
+    char *pos = buffer;
     int count;
 
     if (value->namelen)
@@ -242,18 +245,29 @@ static void dump_value( const struct key_value *value, FILE *f )
     else count += fprintf( f, "hex(%x):", value->type );
     for (i = 0; i < value->len; i++)
     {
-        count += fprintf( f, "%02x", *((unsigned char *)value->data + i) );
+        unsigned char ch = *((unsigned char *)value->data + i);
+
+        if (pos > buffer + sizeof(buffer) - 8)
+        {
+            fwrite( buffer, pos - buffer, 1, f );
+            pos = buffer;
+        }
+        *pos++ = hex[ch >> 4];
+        *pos++ = hex[ch & 0x0f];
+        count += 2;
         if (i < value->len-1)
         {
-            fputc( ',', f );
+            *pos++ = ',';
             if (++count > 76)
             {
-                fprintf( f, "\\\n  " );
+                memcpy( pos, "\\\n  ", 4 );
+                pos += 4;
                 count = 2;
             }
         }
     }
-    fputc( '\n', f );
+    *pos++ = '\n';
+    fwrite( buffer, pos - buffer, 1, f );
 }
 
 /* save a registry and all its subkeys to a text file */
@@ -1476,22 +1490,40 @@ static int load_key_option( struct key *key, const char *buffer, struct file_loa
     return 1;
 }
 
+/* return the value of a hex digit, or -1 if not a hex digit */
+static inline int hex_digit_value( char ch )
+{
+    if (ch >= '0' && ch <= '9') return ch - '0';
+    if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+    if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+    return -1;
+}
+
 /* parse a comma-separated list of hex digits */
 static int parse_hex( unsigned char *dest, data_size_t *len, const char *buffer )
 {
     const char *p = buffer;
     data_size_t count = 0;
-    char *end;
+    unsigned int val;
+    int digit;
 
-    while (isxdigit(*p))
+    while ((digit = hex_digit_value( *p )) != -1)
     {
-        unsigned int val = strtoul( p, &end, 16 );
-        if (end == p || val > 0xff) return -1;
+        val = 0;
+        do
+        {
+            val = (val << 4) | digit;
+            if (val > 0xff) return -1;
+        } while ((digit = hex_digit_value( *++p )) != -1);
+
         if (count++ >= *len) return -1;  /* dest buffer overflow */
         *dest++ = val;
-        p = end;
-        while (isspace(*p)) p++;
-        if (*p == ',') p++;
+        if (*p == ',') p++;  /* common case, no spaces */
+        else
+        {
+            while (isspace(*p)) p++;
+            if (*p == ',') p++;
+        }
         while (isspace(*p)) p++;
     }
     *len = count;
@@ -1639,8 +1671,8 @@ static void load_keys( struct key *key, const char *filename, FILE *f, int prefi
 
     info.filename = filename;
     info.file   = f;
-    info.len    = 4;
-    info.tmplen = 4;
+    info.len    = 256;
+    info.tmplen = 256;
     info.line   = 0;
     if (!(info.buffer = mem_alloc( info.len ))) return;
     if (!(info.tmp = mem_alloc( info.tmplen )))
@@ -1728,6 +1760,8 @@ static int load_init_registry_from_file( const char *filename, struct key *key )
 
     if ((f = fopen( filename, "r" )))
     {
+        /* registry files can be large, avoid many small reads */
+        setvbuf( f, NULL, _IOFBF, 1024 * 1024 );
         load_keys( key, filename, f, 0 );
         fclose( f );
         if (get_error() == STATUS_NOT_REGISTRY_FILE)
@@ -1980,6 +2014,8 @@ static int save_branch( struct key *key, const char *path )
         dump_operation( key, NULL, "saving" );
     }
 
+    /* registry files can be large, avoid many small writes */
+    setvbuf( f, NULL, _IOFBF, 1024 * 1024 );
     save_all_subkeys( key, f );
     ret = !fclose(f);
 
@@ -330,6 +330,10 @@ static void call_req_handler( struct thread *thread )
     current = NULL;
 }
 
+/* buffer reused for the variable-size data of requests that fit in it */
+#define REQ_BUFFER_SIZE 65536
+static void *req_buffer;
+
 /* read a request from a thread */
 void read_request( struct thread *thread )
 {
@@ -337,20 +341,58 @@ void read_request( struct thread *thread )
 
     if (!thread->req_toread)  /* no pending request */
     {
-        if ((ret = read( get_unix_fd( thread->request_fd ), &thread->req,
-                         sizeof(thread->req) )) != sizeof(thread->req)) goto error;
-        if (!(thread->req_toread = thread->req.request_header.request_size))
+        struct iovec vec[2];
+        data_size_t size;
+
+        if (!req_buffer && !(req_buffer = malloc( REQ_BUFFER_SIZE )))
+        {
+            fatal_protocol_error( thread, "no memory for request buffer\n" );
+            return;
+        }
+
+        /* the client waits for the reply before sending anything else, so the
+         * header and the data can be read at once without consuming a following request */
+        vec[0].iov_base = &thread->req;
+        vec[0].iov_len  = sizeof(thread->req);
+        vec[1].iov_base = req_buffer;
+        vec[1].iov_len  = REQ_BUFFER_SIZE;
+
+        if ((ret = readv( get_unix_fd( thread->request_fd ), vec, 2 )) < (int)sizeof(thread->req))
+            goto error;
+        ret -= sizeof(thread->req);
+        size = thread->req.request_header.request_size;
+
+        if (ret > size)
+        {
+            fatal_protocol_error( thread, "request %d: read %d bytes, expected %u\n",
+                                  thread->req.request_header.req, ret, size );
+            return;
+        }
+        if (ret == size)
         {
-            /* no data, handle request at once */
+            /* complete request, handle it at once */
+            if (size)
+            {
+                thread->req_data = req_buffer;
+                req_buffer = NULL;
+            }
             call_req_handler( thread );
+            /* reclaim the buffer, unless the thread got cleaned up by the handler */
+            if (size && thread->req_data)
+            {
+                req_buffer = thread->req_data;
+                thread->req_data = NULL;
+            }
             return;
         }
-        if (!(thread->req_data = malloc( thread->req_toread )))
+        if (!(thread->req_data = malloc( size )))
         {
             fatal_protocol_error( thread, "no memory for %u bytes request %d\n",
-                                  thread->req_toread, thread->req.request_header.req );
+                                  size, thread->req.request_header.req );
             return;
         }
+        memcpy( thread->req_data, req_buffer, ret );
+        thread->req_toread = size - ret;
     }
 
     /* read the variable sized data */